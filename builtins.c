@@ -0,0 +1,704 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that implements the built-in commands of our Shell
+ *   - Every built-in command is a handler function with the same signature, taking the simple command from the command tree (AST)
+ *   - "builtin_table" maps the name of a built-in command to its handler and is kept SORTED by name,
+ *     so find_builtin(...) is a binary search instead of comparing the name with every built-in command one by one
+ *   - run_builtin(...) applies the redirections of the command around the handler, the same way for every built-in command
+ *   - Inside a pipeline, "pipeline.c" runs the BUILTIN_PURE ones in the shell and the others in a subshell
+ *   - Built-in commands print into the output buffer "shell_out" (see "output.c"), which call_builtin(...) writes out
+ *     at the end of the command, counting the bytes and system calls of each built-in command for "outstat"
+ *
+ * To add a built-in command, write its handler here and add it to "builtin_table" in alphabetical order
+ */
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include "sh.h"
+
+extern char **dynamic_envvariables;
+
+static int oldpwd_flag = 1;       // keeps track of when to change from OLDPWD env value to PWD env value or vice versa
+			          // this flag will ONLY be used if "cd -" command is used
+
+/* built-in command bg */
+static int builtin_bg(struct command *cmd){
+	struct job *job;
+
+	if(cmd->argc > 2){
+		printf("bg: Too many arguments.\n");
+		return 1;
+	}
+
+	// "bg %n" resumes job n in background, "bg" resumes the most recent job
+	if((job = job_find(cmd->argv[1], "bg")) == NULL)
+		return 1;
+	if(job->state != JOB_STOPPED){
+		printf("bg: Job %d is already running.\n", job->id);
+		return 1;
+	}
+	job_background(job);
+	return 0;
+}
+
+/* built-in command cd */
+static int builtin_cd(struct command *cmd){
+	char **arg = cmd->argv;
+	char *ptr;
+
+	// We can use chdir(...) function to change from one working directory to another and thus to implement "cd"
+	// We can use OLDPWD env variable to keep track of previously visited directory
+	// Similarly, we can use PWD env variable to keep track of latest working directory
+
+
+	// Check if any args are provided or not
+	// If not provided, then CWD to HOME directory
+	if(arg[1] == NULL){
+
+		// Remember, that we have HOME environment variable which stores the directory for HOME
+		// Thus, we can directly use env_get(...) to get the value for HOME environment variable
+		// Updates OLDPWD env variable and PWD env variable
+		if(env_get("HOME") != NULL && strcmp(env_get("HOME")," ") != 0 && chdir(env_get("HOME")) == 0){
+
+			// Sets an env OLDPWD with its name and value of PWD env in our global variable "dynamic_envvariables"
+			// Call to setenvvariable(...) will:
+			//  -  Modify the existing env variable OLDPWD with the new value of PWD env within "dynamic_envvariables"
+			// Finding a variable is a hash table lookup, so this never rescans the environment
+			setenvvariable("OLDPWD",env_get("PWD") ? env_get("PWD") : "");
+
+			// Sets an env PWD with its name and value of a HOME env in our global variable "dynamic_envvariables"
+			// Call to setenvvariable(...) will:
+			//  -  Modify the existing env variable PWD with the given new value of HOME env within "dynamic_envvariables"
+			setenvvariable("PWD",env_get("HOME"));
+			return 0;
+		}
+
+		// If HOME env value is empty, print an error message
+		printf("cd: Bad Directory.\n");
+		return 1;
+	}
+
+	// Check if second arg is provided or not
+	// If not provided, then that means ONLY first arg is given
+	// If first arg is "-", then go back to previously visited directory
+	// If first arg is path of the directory, then go to that path directory
+	if(arg[2] == NULL){
+
+		// Toggle between value of OLDPWD and value of PWD if "-" is provided as an arg
+		if(strcmp(arg[1],"-") == 0){
+			if(oldpwd_flag){
+				oldpwd_flag = 0;
+				ptr = env_get("OLDPWD");
+			}
+			else{
+				oldpwd_flag = 1;
+				ptr = env_get("PWD");
+			}
+			if(ptr == NULL || chdir(ptr) == -1){
+				printf("cd: Bad Directory.\n");
+				return 1;
+			}
+			return 0;
+		}
+
+		// Print an error message if any files or executables are given instead of a directory
+		if(chdir(arg[1]) == -1){
+			printf("%s: Not a directory\n",arg[1]);
+			return 1;
+		}
+
+		// Changes CWD to specified path given
+		// Updates OLDPWD and PWD
+
+		// Sets an env OLDPWD with its name and value of PWD env in our global variable "dynamic_envvariables"
+		// Call to setenvvariable(...) will:
+		//  -  Modify the existing env variable OLDPWD with the new value of PWD env within "dynamic_envvariables"
+		setenvvariable("OLDPWD",env_get("PWD") ? env_get("PWD") : "");
+
+		ptr = getcwd(NULL,0);
+
+		// Sets an env PWD with its name and value of a CWD in our global variable "dynamic_envvariables"
+		// Call to setenvvariable(...) will:
+		//  -  Modify the existing env variable PWD with the given new value of CWD within "dynamic_envvariables"
+		setenvvariable("PWD",ptr);
+
+		free(ptr);
+		return 0;
+	}
+
+	// This assumes that more than one arg is provided for "cd" command
+	// Print an error message in such case
+	printf("cd: Too many arguments.\n");
+	return 1;
+}
+
+/* built-in command exit */
+static int builtin_exit(struct command *cmd){
+	(void) cmd;
+	exit_shell = 1;
+	return 0;
+}
+
+/* built-in command fg */
+static int builtin_fg(struct command *cmd){
+	struct job *job;
+
+	if(cmd->argc > 2){
+		printf("fg: Too many arguments.\n");
+		return 1;
+	}
+
+	// "fg %n" brings job n to foreground (resuming it if it was stopped), "fg" brings the most recent job
+	if((job = job_find(cmd->argv[1], "fg")) == NULL)
+		return 1;
+	printf("%s\n", job->text);
+	fflush(stdout);
+	return job_foreground(job, job->state == JOB_STOPPED);
+}
+
+/* built-in command hash */
+static int builtin_hash(struct command *cmd){
+	// Prints every command remembered from PATH with its hits, and the hits and misses of the whole table
+	// "hash -r" forgets every remembered command and clears the hits and misses instead, like "rehash"
+	// The implementation of function hash_print(...) is in "hashcmd.c"
+	if(cmd->argc > 1 && strcmp(cmd->argv[1], "-r") == 0){
+		rehash();
+		hash_reset_counters();
+		return 0;
+	}
+	hash_print();
+	return 0;
+}
+
+/* built-in command history */
+static int builtin_history(struct command *cmd){
+	char **arg = cmd->argv + 1, *end;
+	int verbose = 0;
+	long count = 0;
+
+	// "history -v" also prints when, how long, with which exit status and in which directory every command line ran
+	if(*arg != NULL && strcmp(*arg, "-v") == 0){
+		verbose = 1;
+		arg++;
+	}
+
+	// "history n" prints ONLY the last n command lines
+	if(*arg != NULL){
+		count = strtol(*arg, &end, 10);
+		if(*end != '\0' || count <= 0 || arg[1] != NULL){
+			printf("history: Usage: history [-v] [n].\n");
+			return 1;
+		}
+	}
+
+	// The implementation of function history_print(...) is in "history.c"
+	history_print(count, verbose);
+	return 0;
+}
+
+/* built-in command jobs */
+static int builtin_jobs(struct command *cmd){
+	// "jobs -l" also prints the process group of every job and how long it has been running
+	if(cmd->argc > 2 || (cmd->argc == 2 && strcmp(cmd->argv[1], "-l") != 0)){
+		printf("jobs: Usage: jobs [-l].\n");
+		return 1;
+	}
+	jobs_print(cmd->argc == 2);
+	return 0;
+}
+
+/* built-in command kill */
+static int builtin_kill(struct command *cmd){
+	char **arg = cmd->argv;
+
+	// If no args are provided, then print an error message
+	if(arg[1] == NULL){ // empty "kill"
+		printf("kill: Too few arguments.\n");
+		return 1;
+	}
+
+	// If a single arg is provided, then that means ONLY PID is given
+	// In such case, send a SIGTERM to the process with that PID by a call to kill(...)
+	if(arg[2] == NULL){ // ONLY PID is provided
+		int pid = atoi(arg[1]);
+		return kill(pid,SIGTERM) == 0 ? 0 : 1;
+	}
+
+	// If more than one arg is provided, then that means BOTH signal number and PID are given
+	// In such case, send that particular signal to the process with the given PID by a call to kill(...)
+	int signal = atoi(arg[1][0] == '-' ? arg[1] + 1 : arg[1]);
+	int pid = atoi(arg[2]);
+	return kill(pid,signal) == 0 ? 0 : 1;
+}
+
+/* built-in command list */
+static int builtin_list(struct command *cmd){
+	struct list_opts opts = { 0, 0, 0, 0, 0, 0 };
+	char **arg = cmd->argv;
+	char *opt;
+	int i;
+
+	// Options come first, one or more letters after each "-" ("list -sl dir")
+	for(i = 1; arg[i] != NULL && arg[i][0] == '-' && arg[i][1] != '\0'; i++){
+		for(opt = arg[i] + 1; *opt; opt++){
+			switch(*opt){
+				case 's': opts.sort = 1;        break;
+				case 'l': opts.long_format = 1; break;
+				case 'F': opts.classify = 1;    break;
+				case '0': opts.nul = 1;         break;
+				case 'R': opts.recursive = 1;   break;
+				case 'T': opts.totals = 1;      break;
+				default:
+					printf("list: Unknown option -%c.\n",*opt);
+					printf("Usage: list [-slF0RT] [directory ...]\n");
+					return 1;
+			}
+		}
+	}
+
+	// If no directories are provided, then just list the files in the current working directory one per line
+	// Otherwise, for each directory list its files after "the name of the directory" followed by a ":",
+	// and a "blank line" after them
+	// The implementation of function list_dirs(...) is in "list.c"
+	return list_dirs(arg + i, cmd->argc - i, &opts);
+}
+
+/* built-in command noclobber */
+static int builtin_noclobber(struct command *cmd){
+	(void) cmd;
+	noclobber = 1 - noclobber; // switch value
+	printf("%d\n", noclobber);
+	return 0;
+}
+
+/* built-in command outstat */
+static int builtin_outstat(struct command *cmd){
+	(void) cmd;
+	// Prints how much each built-in command printed through "shell_out" and how many system calls it took
+	outstat_print();
+	return 0;
+}
+
+/* built-in command pid */
+static int builtin_pid(struct command *cmd){
+	(void) cmd;
+	// Calls process_id() function to print out the Process ID(PID) of the shell
+	process_id();
+	return 0;
+}
+
+/* built-in command printenv */
+static int builtin_printenv(struct command *cmd){
+	char **arg = cmd->argv;
+	char *ptr;
+
+	// Check if any arguments are provided or not
+	// If not, then call printenv(...) function and print ALL environment variables with its value
+	if(arg[1] == NULL){
+		out_add(&shell_out, "\n", 1);
+		printenv(dynamic_envvariables);
+		return 0;
+	}
+
+	// Check if second arg is provided to "printenv" command
+	// If not, then print associated value of environment variable name given in first arg
+	if(arg[2] == NULL){
+		// The variable is found through the hash table of "dynamic_envvariables" in O(1)
+		ptr = env_get(arg[1]);
+		out_str(&shell_out, ptr ? ptr : "");
+		out_add(&shell_out, "\n", 1);
+		return 0;
+	}
+
+	// This assumes that two or more than two args are given for "printenv" command
+	// In such case, print an error message to STDERR (it ONLY goes to the file for ">&" and ">>&")
+	fprintf(stderr, "printenv: Too many arguments.\n");
+	return 1;
+}
+
+/* built-in command prompt */
+static int builtin_prompt(struct command *cmd){
+	char **arg = cmd->argv;
+
+	// Conditional Statements to check if prompt is given any arguments
+
+	// This conditional statement assumes that no arguments are provided
+	// If no args are provided, then take input from user and store it as prefix in next line
+	if(arg[1] == NULL){
+		printf("input prompt prefix: ");
+		fflush(stdout);
+		// The line comes through the reader of the shell, which may have read ahead of stdio (see "input.c")
+		if(reader_stdin_line(prompt_command_prefix,MAXLINE))
+			prompt_command_flag = 1;
+		return 0;
+	}
+
+	// Check if second arg is given to "prompt" command or not
+	// If there is no second arg, then take the value of first arg and store it as prefix in next line
+	if(arg[2] == NULL){
+		strncpy(prompt_command_prefix,arg[1],MAXLINE - 1);
+		prompt_command_prefix[MAXLINE - 1] = '\0';
+		prompt_command_flag = 1;
+		return 0;
+	}
+
+	// This assumes that two or more than two args are provided
+	// Print an error message in this case
+	printf("prompt: Too many arguments.\n");
+	return 1;
+}
+
+/* built-in command pwd */
+static int builtin_pwd(struct command *cmd){
+	// Prints current working directory on screen by calling getcwd(...) function
+	char *ptr = getcwd(NULL, 0);
+
+	(void) cmd;
+	out_printf(&shell_out, "%s\n", ptr);
+
+	// Frees the space for pointer variable to avoid memory leak
+	free(ptr);
+	return 0;
+}
+
+/* built-in command rehash */
+static int builtin_rehash(struct command *cmd){
+	(void) cmd;
+	// Forgets every command remembered from PATH, so that new executables in PATH are found
+	rehash();
+	hash_reset_counters();
+	return 0;
+}
+
+/* built-in command setenv */
+static int builtin_setenv(struct command *cmd){
+	char **arg = cmd->argv;
+
+	// Check if any args are provided to "setenv" command or not
+	// If none args are given, then call printenv(...) function to print ALL environment variables with its value
+	if(arg[1] == NULL){
+		out_add(&shell_out, "\n", 1);
+		printenv(dynamic_envvariables);
+		return 0;
+	}
+
+	// This assumes that third argument is provided, print an error message
+	if(arg[2] != NULL && arg[3] != NULL){
+		printf("setenv: Too many arguments.\n");
+		return 1;
+	}
+
+	// If second arg is not provided, then that means ONLY name of environment variable is provided
+	// Otherwise BOTH name of environment variable and value of env variable are provided
+	// In such case, do the following steps:
+	//      1. Set an environment variable with its name and value from arg[2] (or an empty value)
+	//      2. Check if that name already exists from environment variable list or not
+	//      3. If it does, then modify its associated value
+	//      4. If not, then add that environment variable as a newly created variable to the end of list
+	// Call to setenvvariable(...) will EITHER:
+	//      1.  Add new env variable at the end of "dynamic_ennvariables" list OR
+	//      2.  Modify the existing env variable with the given new value
+	setenvvariable(arg[1], arg[2] != NULL ? arg[2] : " ");
+
+	// Special care must be given if PATH is changed
+	// The new PATH is parsed once here, and every command remembered from the old PATH must be searched again
+	if(strcmp(arg[1],"PATH") == 0){
+		update_path();
+		rehash();
+	}
+	return 0;
+}
+
+/* built-in command spawnstat */
+static int builtin_spawnstat(struct command *cmd){
+	(void) cmd;
+	// Prints how long posix_spawn(...) took to start the external commands
+	// The implementation of function spawn_print_stats(...) is in "spawn.c"
+	spawn_print_stats();
+	return 0;
+}
+
+/* built-in command stats */
+static int builtin_stats(struct command *cmd){
+	// "stats reset" clears the latencies, "stats" prints them
+	// The implementation of functions stats_print(...) and stats_reset(...) is in "stats.c"
+	if(cmd->argc == 2 && strcmp(cmd->argv[1], "reset") == 0){
+		stats_reset();
+		return 0;
+	}
+	if(cmd->argc != 1){
+		printf("stats: Usage: stats [reset].\n");
+		return 1;
+	}
+	stats_print();
+	return 0;
+}
+
+/* built-in command unsetenv */
+static int builtin_unsetenv(struct command *cmd){
+	char **arg = cmd->argv;
+	int i;
+
+	// Check if any args are provided to "unsetenv" command or not
+	if(arg[1] == NULL){
+		printf("unsetenv: Too few arguments.\n");
+		return 1;
+	}
+
+	// Removes EVERY environment variable given as an argument from our global variable "dynamic_envvariables"
+	// Call to unsetenvvariable(...) finds the variable through the hash table, so no scanning is needed
+	for(i = 1; arg[i] != NULL; i++){
+		unsetenvvariable(arg[i]);
+
+		// Without PATH, no command can be found in PATH anymore
+		if(strcmp(arg[i],"PATH") == 0){
+			update_path();
+			rehash();
+		}
+	}
+	return 0;
+}
+
+/* built-in command wait */
+static int builtin_wait(struct command *cmd){
+	struct job *job = NULL;
+
+	if(cmd->argc > 2){
+		printf("wait: Too many arguments.\n");
+		return 1;
+	}
+
+	// "wait %n" waits for job n and gives its exit status, "wait" waits for EVERY background job
+	if(cmd->argv[1] != NULL && (job = job_find(cmd->argv[1], "wait")) == NULL)
+		return 127;
+	return jobs_wait(job);
+}
+
+/* built-in command watchuser */
+static int builtin_watchuser(struct command *cmd){
+	char **arg = cmd->argv;
+
+	// Creates the watchuser thread if this is the first time watchuser has been runned
+	// The implementation of function watchuser_start(...) is in "watchuser.c"
+	watchuser_start();
+
+	// Check if any arg has been provided to watchuser command
+	if(arg[1] == NULL) {
+		printf("watchuser: Too few arguments.\n");
+		return 1;
+	}
+
+	// "watchuser -w ms" sets the coalescing window of utmp changes, "watchuser -w" prints it
+	if(strcmp(arg[1], "-w") == 0){
+		if(arg[2] == NULL)
+			printf("%d ms\n", watchuser_get_window());
+		else if(arg[3] == NULL && atoi(arg[2]) >= 0)
+			watchuser_set_window(atoi(arg[2]));
+		else{
+			printf("watchuser: Usage: watchuser -w [ms].\n");
+			return 1;
+		}
+		return 0;
+	}
+
+	// Check if second arg has been provided to watchuser command
+	// If not provided, then that means ONLY name of the user is given
+	// If that's the case, then just ADD that user into the "watchuser_set"
+	if(arg[2] == NULL) {
+
+		// Check if user is already present in the global linked list
+		// If user is not present, then add it to the global linked list
+		if(!searchUser(arg[1]))
+			addUser(arg[1]);
+
+		// Else print error message saying that user is already present
+		else
+			printf("User %s is already present in the watchlist...\n",arg[1]);
+		return 0;
+	}
+
+	// Check if "off" arg has been provided to watchuser command
+	// If provided, then remove the user in the first arg from the "watchuser_set"
+	if(strcmp(arg[2], "off") == 0){
+		removeUser(arg[1]);
+		return 0;
+	}
+
+	// This assumes that more than one user is provided for watchuser command
+	// This should produce an error
+	printf("watchuser: Too many arguments.\n");
+	return 1;
+}
+
+/*
+ * Resolves EVERY argument of "where" or "which" in ONE pass over PATH and prints the matches of each argument in order
+ * "first_only" prints ONLY the first match (which)
+ */
+static int where_which(struct command *cmd, int first_only){
+	struct resolved *res;
+	int nnames = cmd->argc - 1, i, j;
+
+	if(nnames == 0){  // "empty" where or which
+		fprintf(stderr, "%s: Too few arguments.\n",cmd->argv[0]);
+		return 1;
+	}
+
+	// The implementation of function resolve_commands(...) is in "where.c"
+	res = (struct resolved *) malloc(sizeof(struct resolved) * nnames);
+	resolve_commands(get_path(), cmd->argv + 1, nnames, first_only, res);
+
+	for(i = 0; i < nnames; i++){
+		if(res[i].count == 0)           // argument not found
+			out_printf(&shell_out, "%s: Command not found\n", cmd->argv[i + 1]);
+		for(j = 0; j < res[i].count; j++){
+			out_str(&shell_out, res[i].paths[j]);
+			out_add(&shell_out, "\n", 1);
+		}
+	}
+
+	free_resolved(res, nnames);
+	free(res);
+	return 0;
+}
+
+/* built-in command where */
+static int builtin_where(struct command *cmd){
+	// "where" command will locate ALL instance of ALL args if it would be possible
+	return where_which(cmd, 0);
+}
+
+/* built-in command which */
+static int builtin_which(struct command *cmd){
+	// "which" command will locate first instance of ALL args if it would be possible
+	return where_which(cmd, 1);
+}
+
+// Every built-in command of the shell, SORTED by name for find_builtin(...)
+static const struct builtin builtin_table[] = {
+	{ "bg",        builtin_bg,        0             },
+	{ "cd",        builtin_cd,        0             },
+	{ "exit",      builtin_exit,      BUILTIN_QUIET },
+	{ "fg",        builtin_fg,        0             },
+	{ "hash",      builtin_hash,      0             },
+	{ "history",   builtin_history,   BUILTIN_PURE  },
+	{ "jobs",      builtin_jobs,      BUILTIN_PURE  },
+	{ "kill",      builtin_kill,      0             },
+	{ "list",      builtin_list,      BUILTIN_PURE  },
+	{ "noclobber", builtin_noclobber, 0             },
+	{ "outstat",   builtin_outstat,   BUILTIN_PURE  },
+	{ "pid",       builtin_pid,       BUILTIN_PURE  },
+	{ "printenv",  builtin_printenv,  BUILTIN_PURE  },
+	{ "prompt",    builtin_prompt,    0             },
+	{ "pwd",       builtin_pwd,       BUILTIN_PURE  },
+	{ "rehash",    builtin_rehash,    0             },
+	{ "setenv",    builtin_setenv,    0             },
+	{ "spawnstat", builtin_spawnstat, BUILTIN_PURE  },
+	{ "stats",     builtin_stats,     0             },
+	{ "unsetenv",  builtin_unsetenv,  0             },
+	{ "wait",      builtin_wait,      0             },
+	{ "watchuser", builtin_watchuser, 0             },
+	{ "where",     builtin_where,     BUILTIN_PURE  },
+	{ "which",     builtin_which,     BUILTIN_PURE  },
+};
+
+#define NBUILTINS (sizeof(builtin_table) / sizeof(builtin_table[0]))
+
+// What every built-in command printed through "shell_out", for "outstat"
+// A built-in command that ran in a subshell is counted in the subshell ONLY
+struct output_stats {
+	unsigned long      runs;
+	unsigned long long bytes;
+	unsigned long      writes;
+};
+
+static struct output_stats output_stats[NBUILTINS];
+
+// Compares the name being looked up with the name of an entry of "builtin_table" for bsearch(...)
+static int compare_builtin(const void *name, const void *entry){
+	return strcmp((const char *) name, ((const struct builtin *) entry)->name);
+}
+
+/*
+ * This function finds the built-in command with the given name
+ * Returns NULL if there is no such built-in command, in which case the command is an external command
+ */
+const struct builtin *find_builtin(const char *name){
+	return (const struct builtin *) bsearch(name, builtin_table, NBUILTINS, sizeof(struct builtin), compare_builtin);
+}
+
+/*
+ * This function returns the name of the built-in command number "i" in alphabetical order, or NULL after the last one
+ */
+const char *builtin_name(int i){
+	return i >= 0 && (size_t) i < NBUILTINS ? builtin_table[i].name : NULL;
+}
+
+/*
+ * This function calls the handler of the given built-in command and writes out what it printed into "shell_out"
+ * The file descriptors must already be redirected, the bytes and system calls are counted for "outstat"
+ * and how long it took for "stats"
+ * Returns the exit status of the built-in command
+ */
+int call_builtin(const struct builtin *b, struct command *cmd){
+	struct output_stats *st = &output_stats[b - builtin_table];
+	unsigned long long bytes = shell_out.bytes;
+	unsigned long writes = shell_out.writes;
+	long long start = stats_now();
+	int status;
+
+	status = b->handler(cmd);
+	out_flush(&shell_out);
+	stats_record_builtin(b - builtin_table, stats_now() - start);
+
+	st->runs++;
+	st->bytes += shell_out.bytes - bytes;
+	st->writes += shell_out.writes - writes;
+	return status;
+}
+
+/*
+ * This is the helper function for implementing "outstat" command
+ * It prints the bytes and system calls of every built-in command that printed something, with the bytes per system call
+ */
+void outstat_print(){
+	struct output_stats *st;
+	size_t i;
+
+	// What "outstat" prints now is counted the next time
+	out_printf(&shell_out, "%-10s %8s %12s %8s %12s\n", "built-in", "runs", "bytes", "writes", "bytes/write");
+	for(i = 0; i < NBUILTINS; i++){
+		st = &output_stats[i];
+		if(st->runs == 0)
+			continue;
+		out_printf(&shell_out, "%-10s %8lu %12llu %8lu %12llu\n", builtin_table[i].name, st->runs, st->bytes, st->writes,
+			st->writes ? st->bytes / st->writes : 0);
+	}
+}
+
+/*
+ * This function runs the given built-in command inside the shell itself
+ * Redirections of the command are applied to the shell by redirect_builtin(...) and undone by restore_builtin(...) afterwards
+ * Returns the exit status of the built-in command (0 on success)
+ */
+int run_builtin(const struct builtin *b, struct command *cmd){
+	struct fd_plan plan;
+	int status;
+
+	if(!(b->flags & BUILTIN_QUIET))
+		printf("Executing built-in [%s]\n", b->name);
+
+	if(redirect_builtin(&plan, cmd, -1, -1, 0) == -1)
+		return 1;
+
+	status = call_builtin(b, cmd);
+
+	restore_builtin(&plan);
+	return status;
+}
@@ -0,0 +1,520 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that implements the TAB completion of the line editor of our Shell
+ *   - A command name is completed from a trie of EVERY built-in command and EVERY executable of PATH, built from the
+ *     PATH index of "pathindex.c"; the trie is built again ONLY when the index changed (its generation number)
+ *     A relative directory of PATH (like ".") is not indexed, so its commands are not completed
+ *   - Any other word (or a command with a "/") is completed from the names of its directory
+ *     A directory is read ONCE with getdents64(...) and kept sorted, so completing is a binary search even with
+ *     hundreds of thousands of names; an inotify watch on the directory keeps its names up to date: a name that is
+ *     created or removed is added to or removed from the sorted names, so the directory is NEVER read again
+ *   - The last DIR_CACHE_SIZE directories are kept, the one that was not used for the longest time makes room for a new one
+ */
+
+#define _GNU_SOURCE
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sh.h"
+
+#define DIR_CACHE_SIZE  16
+#define DENTS_BUFSIZE   (1 << 20)
+#define RESOLVE_MAX     256      // links and unknown types are looked at ONLY when there are at most this many candidates
+#define WATCH_EVENTS    (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR)
+
+// ONE node of the trie of commands
+struct trie_node {
+	int  child;      // first child, -1 if none; the children are sorted by "c"
+	int  sibling;    // next child of the same parent, -1 if none
+	int  name;       // offset of the command in "trie_names" if a command ends here, -1 otherwise
+	unsigned char c;
+};
+
+static struct trie_node *trie = NULL;
+static int    trie_count = 0, trie_cap = 0;
+static char  *trie_names = NULL;            // EVERY command, one after another, each NUL terminated
+static size_t trie_names_len = 0, trie_names_cap = 0;
+static int    trie_built = 0;
+static unsigned int trie_generation;        // generation of the PATH index the trie was built from
+static char  *trie_path = NULL;             // PATH the trie was built for
+
+// ONE name of a cached directory
+struct comp_entry {
+	uint32_t      name;   // offset of the name in the pool of the directory
+	unsigned char type;   // "d_type" from getdents64(...)
+};
+
+// ONE directory of the cache
+struct cached_dir {
+	char   *path;         // absolute path, NULL for an empty slot
+	int     fd;           // the directory, to look at links
+	int     wd;           // inotify watch of the directory
+	char   *pool;
+	size_t  poolsize, poolcap;
+	size_t  garbage;      // bytes of the pool used by names that were removed
+	struct comp_entry *entries;   // sorted by name
+	int     nentries, cap;
+	unsigned long used;   // when it was last used, to find the one to throw away
+};
+
+static struct cached_dir dir_cache[DIR_CACHE_SIZE];
+static unsigned long dir_clock = 0;
+static int inotify_fd = -2;      // -2 until it is created, -1 if inotify can't be used
+
+static int new_node(unsigned char c){
+	if(trie_count == trie_cap){
+		trie_cap = trie_cap ? 2 * trie_cap : 4096;
+		trie = (struct trie_node *) realloc(trie, sizeof(struct trie_node) * trie_cap);
+	}
+	trie[trie_count].child = trie[trie_count].sibling = trie[trie_count].name = -1;
+	trie[trie_count].c = c;
+	return trie_count++;
+}
+
+// Adds ONE command to the trie, a command that is already there (in an earlier PATH directory) is added ONCE
+static void trie_add(const char *name, void *unused){
+	const unsigned char *p;
+	int node = 0, *link, next;
+	size_t len;
+
+	(void) unused;
+	for(p = (const unsigned char *) name; *p; p++){
+		// Finds the child for this character, keeping the children sorted
+		for(link = &trie[node].child; *link != -1 && trie[*link].c < *p; link = &trie[*link].sibling);
+		if(*link == -1 || trie[*link].c != *p){
+			next = new_node(*p);
+			trie[next].sibling = *link;
+			*link = next;
+		}
+		node = *link;
+	}
+	if(trie[node].name != -1)
+		return;
+
+	len = strlen(name) + 1;
+	if(trie_names_len + len > trie_names_cap){
+		trie_names_cap = trie_names_cap ? 2 * trie_names_cap : 65536;
+		while(trie_names_len + len > trie_names_cap)
+			trie_names_cap *= 2;
+		trie_names = (char *) realloc(trie_names, trie_names_cap);
+	}
+	memcpy(trie_names + trie_names_len, name, len);
+	trie[node].name = (int) trie_names_len;
+	trie_names_len += len;
+}
+
+// Builds the trie again if PATH or a PATH directory changed since it was built
+static void trie_update(){
+	struct pathlist *p = get_path();
+	char *path = env_get("PATH");
+	const char *name;
+	int i;
+
+	pathindex_revalidate();
+	if(trie_built && pathindex_generation() == trie_generation && strcmp(trie_path, path ? path : "") == 0)
+		return;
+
+	trie_count = 0;
+	trie_names_len = 0;
+	new_node(0);
+	for(i = 0; (name = builtin_name(i)) != NULL; i++)
+		trie_add(name, NULL);
+	for(i = 0; i < p->count; i++)
+		pathindex_names(i, trie_add, NULL);
+
+	// Reading the index may have loaded it, so the generation is taken afterwards
+	trie_generation = pathindex_generation();
+	free(trie_path);
+	trie_path = strdup(path ? path : "");
+	trie_built = 1;
+}
+
+static void add_candidate(struct completion *c, const char *name, unsigned char type){
+	if(c->n == c->cap){
+		c->cap = c->cap ? 2 * c->cap : 64;
+		c->v = (struct candidate *) realloc(c->v, sizeof(struct candidate) * c->cap);
+	}
+	c->v[c->n].name = name;
+	c->v[c->n].type = type;
+	c->n++;
+}
+
+// Adds every command under the node of the trie, in sorted order
+static void trie_collect(int node, struct completion *c){
+	if(trie[node].name != -1)
+		add_candidate(c, trie_names + trie[node].name, DT_REG);
+	for(node = trie[node].child; node != -1; node = trie[node].sibling)
+		trie_collect(node, c);
+}
+
+// Finds the commands that start with the prefix
+static void complete_command(const char *prefix, struct completion *c){
+	const unsigned char *p;
+	int node = 0;
+
+	trie_update();
+	for(p = (const unsigned char *) prefix; *p && node != -1; p++)
+		for(node = trie[node].child; node != -1 && trie[node].c != *p; node = trie[node].sibling);
+	if(node != -1)
+		trie_collect(node, c);
+}
+
+static void dir_free(struct cached_dir *d){
+	free(d->path);
+	free(d->pool);
+	free(d->entries);
+	if(d->fd != -1)
+		close(d->fd);
+	memset(d, 0, sizeof(*d));
+	d->fd = -1;
+}
+
+// Throws away the directory, and its watch if no other directory of the cache has the same one (the same directory through a link)
+static void dir_drop(struct cached_dir *d, int watch_gone){
+	int i, shared = 0;
+
+	for(i = 0; i < DIR_CACHE_SIZE; i++)
+		if(&dir_cache[i] != d && dir_cache[i].path != NULL && dir_cache[i].wd == d->wd)
+			shared = 1;
+	if(!shared && !watch_gone && d->wd >= 0)
+		inotify_rm_watch(inotify_fd, d->wd);
+	dir_free(d);
+}
+
+static int comp_entry_cmp(const void *a, const void *b, void *pool){
+	return strcmp((char *) pool + ((const struct comp_entry *) a)->name, (char *) pool + ((const struct comp_entry *) b)->name);
+}
+
+// Adds a name to the pool of the directory, returns its offset
+static uint32_t pool_add(struct cached_dir *d, const char *name){
+	size_t len = strlen(name) + 1, at = d->poolsize;
+
+	if(d->poolsize + len > d->poolcap){
+		d->poolcap = d->poolcap ? 2 * d->poolcap : 65536;
+		while(d->poolsize + len > d->poolcap)
+			d->poolcap *= 2;
+		d->pool = (char *) realloc(d->pool, d->poolcap);
+	}
+	memcpy(d->pool + at, name, len);
+	d->poolsize += len;
+	return (uint32_t) at;
+}
+
+// Makes room for one more name
+static void entries_grow(struct cached_dir *d){
+	if(d->nentries == d->cap){
+		d->cap = d->cap ? 2 * d->cap : 256;
+		d->entries = (struct comp_entry *) realloc(d->entries, sizeof(struct comp_entry) * d->cap);
+	}
+}
+
+// Reads EVERY name of the directory into the slot, except "." and ".."
+static void dir_read(struct cached_dir *d){
+	char *dents = (char *) malloc(DENTS_BUFSIZE);
+	long pos, got;
+
+	while((got = getdents64(d->fd, dents, DENTS_BUFSIZE)) > 0){
+		for(pos = 0; pos < got; ){
+			struct dirent64 *de = (struct dirent64 *) (dents + pos);
+			pos += de->d_reclen;
+
+			if(de->d_name[0] == '.' && (de->d_name[1] == '\0' || (de->d_name[1] == '.' && de->d_name[2] == '\0')))
+				continue;
+
+			entries_grow(d);
+			d->entries[d->nentries].name = pool_add(d, de->d_name);
+			d->entries[d->nentries].type = de->d_type;
+			d->nentries++;
+		}
+	}
+	free(dents);
+	qsort_r(d->entries, d->nentries, sizeof(struct comp_entry), comp_entry_cmp, d->pool);
+}
+
+// Finds where the name is (or would be) in the sorted names of the directory
+static int dir_find(struct cached_dir *d, const char *name){
+	int lo = 0, hi = d->nentries, mid;
+
+	while(lo < hi){
+		mid = lo + (hi - lo) / 2;
+		if(strcmp(d->pool + d->entries[mid].name, name) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+// A name was created in the directory (or moved into it)
+static void dir_insert(struct cached_dir *d, const char *name, unsigned char type){
+	int i = dir_find(d, name);
+
+	if(i < d->nentries && strcmp(d->pool + d->entries[i].name, name) == 0){
+		d->entries[i].type = type;
+		return;
+	}
+	entries_grow(d);
+	memmove(&d->entries[i + 1], &d->entries[i], sizeof(struct comp_entry) * (d->nentries - i));
+	d->entries[i].name = pool_add(d, name);
+	d->entries[i].type = type;
+	d->nentries++;
+}
+
+// A name was removed from the directory (or moved out of it), its bytes stay in the pool
+static void dir_remove(struct cached_dir *d, const char *name){
+	int i = dir_find(d, name);
+
+	if(i < d->nentries && strcmp(d->pool + d->entries[i].name, name) == 0){
+		memmove(&d->entries[i], &d->entries[i + 1], sizeof(struct comp_entry) * (d->nentries - i - 1));
+		d->nentries--;
+		d->garbage += strlen(name) + 1;
+	}
+}
+
+// Reads the events of the inotify watches and applies them to the cached directories
+static void dir_cache_events(){
+	char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	struct inotify_event *ev;
+	struct cached_dir *d;
+	ssize_t got, off;
+	int i;
+
+	while((got = read(inotify_fd, buf, sizeof(buf))) > 0){
+		for(off = 0; off < got; off += sizeof(struct inotify_event) + ev->len){
+			ev = (struct inotify_event *) (buf + off);
+
+			for(i = 0; i < DIR_CACHE_SIZE; i++){
+				d = &dir_cache[i];
+				if(d->path == NULL || (d->wd != ev->wd && !(ev->mask & IN_Q_OVERFLOW)))
+					continue;
+
+				// Too many events were lost, or the directory itself is gone: it is read again when it is needed
+				if(ev->mask & (IN_Q_OVERFLOW | IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF))
+					dir_drop(d, (ev->mask & IN_IGNORED) != 0);
+				else if(ev->len > 0 && (ev->mask & (IN_CREATE | IN_MOVED_TO)))
+					dir_insert(d, ev->name, (ev->mask & IN_ISDIR) ? DT_DIR : DT_UNKNOWN);
+				else if(ev->len > 0 && (ev->mask & (IN_DELETE | IN_MOVED_FROM))){
+					dir_remove(d, ev->name);
+
+					// A directory that changes all the time is read again once most of its pool is removed names
+					if(d->garbage > (1 << 20) && 2 * d->garbage > d->poolsize)
+						dir_drop(d, 0);
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Finds the directory in the cache, reading it if it is not there
+ * Returns NULL if it can't be read
+ */
+static struct cached_dir *dir_get(const char *path){
+	struct cached_dir *d = NULL;
+	int i, wd = -1, fd;
+
+	if(inotify_fd == -2)
+		inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(inotify_fd >= 0)
+		dir_cache_events();
+
+	for(i = 0; i < DIR_CACHE_SIZE; i++){
+		if(dir_cache[i].path != NULL && strcmp(dir_cache[i].path, path) == 0){
+			// Without a watch, nothing tells that the directory changed: it is read again
+			if(dir_cache[i].wd < 0){
+				dir_drop(&dir_cache[i], 1);
+				break;
+			}
+			dir_cache[i].used = ++dir_clock;
+			return &dir_cache[i];
+		}
+	}
+
+	// An empty slot, or the one that was not used for the longest time
+	// It is emptied BEFORE the new watch is added: the same directory under another path gets the same watch from inotify,
+	// and dropping that entry afterwards would remove the watch of the new one too
+	for(i = 0; i < DIR_CACHE_SIZE; i++)
+		if(d == NULL || dir_cache[i].path == NULL || dir_cache[i].used < d->used){
+			d = &dir_cache[i];
+			if(d->path == NULL)
+				break;
+		}
+	if(d->path != NULL)
+		dir_drop(d, 0);
+
+	// The watch is added BEFORE the directory is read, so a change while it is read is not missed
+	if(inotify_fd >= 0)
+		wd = inotify_add_watch(inotify_fd, path, WATCH_EVENTS);
+	if((fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) < 0)
+		return NULL;
+
+	d->path = strdup(path);
+	d->fd = fd;
+	d->wd = wd;
+	d->used = ++dir_clock;
+	dir_read(d);
+
+	return d;
+}
+
+// Finds the names of the directory that start with the prefix, with a binary search
+static void complete_file(const char *dir, const char *prefix, int commands_only, struct completion *c){
+	char path[PATH_MAX], *cwd;
+	struct cached_dir *d;
+	struct comp_entry *e;
+	struct stat st;
+	size_t plen = strlen(prefix);
+	int i;
+
+	if(dir[0] == '/')
+		snprintf(path, sizeof(path), "%s", dir);
+	else{
+		if((cwd = getcwd(NULL, 0)) == NULL)
+			return;
+		snprintf(path, sizeof(path), "%s/%s", cwd, dir);
+		free(cwd);
+	}
+	if((d = dir_get(path)) == NULL)
+		return;
+
+	for(i = dir_find(d, prefix); i < d->nentries; i++){
+		e = &d->entries[i];
+		if(strncmp(d->pool + e->name, prefix, plen) != 0)
+			break;
+
+		// Hidden files ONLY when the prefix asks for them
+		if(d->pool[e->name] == '.' && prefix[0] != '.')
+			continue;
+		add_candidate(c, d->pool + e->name, e->type);
+	}
+
+	// A link may lead to a directory, and some file systems don't tell the type at all
+	if(c->n <= RESOLVE_MAX){
+		for(i = 0; i < c->n; i++)
+			if((c->v[i].type == DT_LNK || c->v[i].type == DT_UNKNOWN) && fstatat(d->fd, c->v[i].name, &st, 0) == 0)
+				c->v[i].type = S_ISDIR(st.st_mode) ? DT_DIR : DT_REG;
+	}
+
+	// A command with a "/" is an executable or a directory on the way to one
+	if(commands_only){
+		int n = 0;
+		for(i = 0; i < c->n; i++)
+			if(c->v[i].type == DT_DIR || faccessat(d->fd, c->v[i].name, X_OK, AT_EACCESS) == 0 || c->n > RESOLVE_MAX)
+				c->v[n++] = c->v[i];
+		c->n = n;
+	}
+}
+
+static int is_operator(char ch){
+	return ch == '|' || ch == '&' || ch == ';' || ch == '<' || ch == '>';
+}
+
+/*
+ * This function finds what the word at the cursor can be completed to
+ *   - The line is split into words the way "lexer.c" does it, up to the cursor, and the word at the cursor is taken without its
+ *     quotes and backslashes
+ *   - The first word of a command is completed as a command, any other word as a file
+ * The candidates are sorted, their names stay valid until the next call
+ * Returns the number of candidates
+ */
+int complete(const char *line, size_t pos, struct completion *c){
+	size_t i = 0, len;
+	int command = 1, in_word = 0, redirect = 0, word_command = 0;
+	char *word = (char *) malloc(pos + 1), *slash, *dir;
+
+	c->n = 0;
+	c->quote = 0;
+	len = 0;
+
+	while(i < pos){
+		char ch = line[i];
+
+		if(!in_word && c->quote == 0){
+			if(ch == ' ' || ch == '\t'){
+				i++;
+				continue;
+			}
+			if(is_operator(ch)){
+				// After "|", "&" and ";" comes a new command, after "<" and ">" a file
+				redirect = (ch == '<' || ch == '>');
+				if(!redirect)
+					command = 1;
+				i++;
+				continue;
+			}
+			in_word = 1;
+			len = 0;
+			word_command = command && !redirect;
+		}
+
+		if(c->quote != 0){
+			if(ch == c->quote)
+				c->quote = 0;
+			else if(c->quote == '"' && ch == '\\' && i + 1 < pos && (line[i + 1] == '"' || line[i + 1] == '\\'))
+				word[len++] = line[++i];
+			else
+				word[len++] = ch;
+			i++;
+			continue;
+		}
+		if(ch == ' ' || ch == '\t' || is_operator(ch)){
+			// The word before the cursor ended
+			in_word = 0;
+			if(word_command)
+				command = 0;
+			redirect = 0;
+			continue;
+		}
+		if(ch == '\'' || ch == '"')
+			c->quote = ch;
+		else if(ch == '\\' && i + 1 < pos)
+			word[len++] = line[++i];
+		else
+			word[len++] = ch;
+		i++;
+	}
+	if(!in_word){
+		len = 0;
+		word_command = command && !redirect;
+	}
+	word[len] = '\0';
+
+	// "dir/prefix": the names of "dir" that start with "prefix"
+	if((slash = strrchr(word, '/')) != NULL){
+		dir = strndup(word, slash - word + 1);
+		complete_file(dir, slash + 1, word_command, c);
+		free(c->prefix);
+		c->prefix = strdup(slash + 1);
+		free(dir);
+	}
+	else{
+		free(c->prefix);
+		c->prefix = strdup(word);
+		if(word_command)
+			complete_command(word, c);
+		else
+			complete_file("", word, 0, c);
+	}
+	free(word);
+	return c->n;
+}
+
+/*
+ * This function frees the candidates of the completion
+ */
+void completion_free(struct completion *c){
+	free(c->v);
+	free(c->prefix);
+	memset(c, 0, sizeof(*c));
+}
@@ -0,0 +1,270 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that implements the event loop of our Shell
+ *   - While the shell waits for a command line, it sleeps in epoll_wait(...) on EVERYTHING it has to react to:
+ *       1. the input from the terminal
+ *       2. a signalfd for SIGCHLD, SIGINT, SIGTSTP and SIGTERM, which are blocked, so no signal handler runs at all
+ *       3. a pidfd for every child, which becomes readable when that child exits
+ *       4. an eventfd that the watchuser thread writes to after it queued a notification
+ *   - So reaping children, printing notifications and redrawing the prompt ALL happen here, on the main thread,
+ *     and nothing is printed in the middle of other output
+ *   - At the prompt the keys go to the line editor of "lineedit.c" as they arrive
+ *   - Without a terminal (a script), there is no event loop: lines are read with read_line(...) and
+ *     the watchuser notifications are printed between two command lines
+ */
+
+#define _GNU_SOURCE
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include "sh.h"
+
+#define MAX_EVENTS 16
+
+static int epfd = -1;      // epoll instance, ONLY for the interactive shell
+static int sigfd = -1;     // signalfd for the signals of the shell
+static int evfd = -1;      // eventfd written after a notification is queued
+static int input_fd = -1;  // file descriptor the command lines come from
+
+// Notifications queued by other threads, printed by the main thread
+struct notification {
+	char *text;
+	struct notification *next;
+};
+static struct notification *queue_head = NULL, **queue_tail = &queue_head;
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Adds the file descriptor to the epoll instance
+static void watch_fd(int fd){
+	struct epoll_event ev;
+
+	ev.events = EPOLLIN;
+	ev.data.fd = fd;
+	epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+/*
+ * This function sets up the event loop
+ *   - The notification queue is always there
+ *   - With "interactive", the signals of the shell are blocked and read from a signalfd instead, and epoll watches the input
+ */
+void event_init(int fd, int interactive){
+	sigset_t mask;
+
+	input_fd = fd;
+	evfd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if(!interactive)
+		return;
+
+	// SIGTERM is ignored by the shell, but it could pass SIGTERM signal to another process with "kill"
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGCHLD);
+	sigaddset(&mask, SIGINT);
+	sigaddset(&mask, SIGTSTP);
+	sigaddset(&mask, SIGTERM);
+	sigprocmask(SIG_BLOCK, &mask, NULL);
+	sigfd = signalfd(-1, &mask, SFD_CLOEXEC | SFD_NONBLOCK);
+
+	epfd = epoll_create1(EPOLL_CLOEXEC);
+	watch_fd(input_fd);
+	watch_fd(sigfd);
+	watch_fd(evfd);
+}
+
+/*
+ * This function returns a pidfd for the given child, watched by the event loop, or -1 if there is no event loop
+ * The pidfd is closed by the job table once the child has been reaped, which also removes it from epoll
+ */
+int event_watch_child(pid_t pid){
+	int fd;
+
+	if(epfd == -1)
+		return -1;
+	fd = (int) syscall(SYS_pidfd_open, pid, 0);
+	if(fd >= 0)
+		watch_fd(fd);
+	return fd;
+}
+
+/*
+ * This function queues a notification to be printed by the main thread
+ * It is safe to call from ANY thread, the text is copied
+ */
+void event_notify(const char *text){
+	struct notification *n = (struct notification *) malloc(sizeof(struct notification));
+	uint64_t one = 1;
+
+	n->text = strdup(text);
+	n->next = NULL;
+
+	pthread_mutex_lock(&queue_lock);
+	*queue_tail = n;
+	queue_tail = &n->next;
+	pthread_mutex_unlock(&queue_lock);
+
+	// Wakes the event loop up, eventfd adds up the writes so no wakeup is ever lost
+	if(evfd != -1)
+		write(evfd, &one, sizeof(one));
+}
+
+/*
+ * This function prints every queued notification
+ * "at_prompt" starts a new line first, since the cursor is right after the prompt
+ * Returns the number of notifications printed
+ */
+int event_drain(int at_prompt){
+	struct notification *n, *next;
+	uint64_t count;
+	int printed = 0;
+
+	if(evfd != -1)
+		read(evfd, &count, sizeof(count));
+
+	// Take the whole queue at once, so the watchuser thread never waits for the printing
+	pthread_mutex_lock(&queue_lock);
+	n = queue_head;
+	queue_head = NULL;
+	queue_tail = &queue_head;
+	pthread_mutex_unlock(&queue_lock);
+
+	if(n != NULL && at_prompt)
+		printf("\n");
+	for( ; n != NULL; n = next){
+		next = n->next;
+		fputs(n->text, stdout);
+		free(n->text);
+		free(n);
+		printed++;
+	}
+	fflush(stdout);
+	return printed;
+}
+
+// Reaps the children that changed state and reports the jobs that finished or stopped right away
+// Returns 1 if anything was printed, so the prompt has to be printed again
+static int notify_jobs(){
+	jobs_reap();
+	if(!jobs_changed())
+		return 0;
+	printf("\n");
+	jobs_notify(1);
+	return 1;
+}
+
+// Handles the signals that arrived while the shell waits at the prompt
+// Returns 1 if the prompt has to be printed again
+static int handle_signals(struct reader *rd){
+	struct signalfd_siginfo si;
+	int redraw = 0;
+
+	while(read(sigfd, &si, sizeof(si)) == sizeof(si)){
+		switch(si.ssi_signo){
+			case SIGINT:     // CTRL-C throws away what was typed so far and continues from next prompt
+				reader_discard(rd);
+				edit_discard();
+				printf("\n");
+				redraw = 1;
+				break;
+			case SIGCHLD:    // a background job stopped or finished
+				redraw |= notify_jobs();
+				break;
+			default:         // CTRL-Z and SIGTERM are ignored by the shell itself
+				break;
+		}
+	}
+	return redraw;
+}
+
+/*
+ * This function returns the next command line, or NULL on end of input
+ * The interactive shell waits in epoll_wait(...) and handles signals, exited children and notifications meanwhile,
+ * printing the prompt again after anything it printed
+ */
+char *event_read_line(struct reader *rd){
+	struct epoll_event events[MAX_EVENTS];
+	char *line;
+	ssize_t got;
+	int n, i, redraw, editing, eof = 0;
+	long long woke = stats_now();   // the last wakeup, the time before it was spent waiting for the user
+
+	if(epfd == -1){
+		event_drain(0);
+		woke = stats_now();
+		if((line = read_line(rd)) != NULL)
+			stats_record(PHASE_READ, stats_now() - woke);
+		return line;
+	}
+
+	// Without raw mode (the terminal refused it), the terminal itself edits the line
+	editing = edit_begin();
+
+	for(;;){
+		line = editing ? edit_process(rd, &eof) : reader_take_line(rd, 0);
+		if(line != NULL || eof)
+			break;
+
+		n = epoll_wait(epfd, events, MAX_EVENTS, -1);
+		woke = stats_now();
+		if(n < 0)
+			continue;
+
+		redraw = 0;
+		for(i = 0; i < n && !eof; i++){
+			int fd = events[i].data.fd;
+
+			if(fd == input_fd){
+				got = reader_fill(rd);
+				if(got < 0 && errno == EINTR)
+					continue;
+				if(got < 0 && errno == EAGAIN)
+					continue;
+
+				// End of input (CTRL-D): the last line may not have a newline at its end
+				if(got <= 0){
+					line = editing ? NULL : reader_take_line(rd, 1);
+					eof = 1;
+				}
+			}
+			else if(fd == sigfd){
+				redraw |= handle_signals(rd);
+			}
+			else if(fd == evfd){
+				if(event_drain(1) > 0)
+					redraw = 1;
+			}
+			else{
+				// A pidfd: the child exited, the job table reaps it and closes the pidfd
+				redraw |= notify_jobs();
+			}
+		}
+
+		if(eof)
+			break;
+		if(redraw){
+			if(editing)
+				edit_redraw();
+			else
+				print_prompt();
+		}
+	}
+
+	// The command line runs with the terminal as it was
+	if(editing)
+		edit_end();
+	if(line != NULL)
+		stats_record(PHASE_READ, stats_now() - woke);
+	return line;
+}
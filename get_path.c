@@ -3,46 +3,68 @@
   Ben Miller
 
   Just a little sample function that gets the PATH env var, parses it and
-  puts "components" into a linked list, which is returned.
+  puts "components" into a flat array, which is returned.
+
+  The array and the strings of the dirs live in ONE block of memory, so the
+  whole path is walked without chasing pointers, and PATH is parsed only
+  once: the same array is returned until update_path() is called.
 */
 #include "get_path.h"
 
-struct pathelement *get_path()
+static struct pathlist shell_path;	/* the parsed PATH of the shell */
+static int parsed = 0;			/* set once shell_path is valid */
+
+/* parses PATH into shell_path */
+static void parse_path()
 {
-  /* path is a copy of the PATH and p is a temp pointer */
-  char *path, *p;
-
-  /* tmp is a temp point used to create a linked list and pathlist is a
-     pointer to the head of the list */
-  struct pathelement *tmp, *pathlist = NULL;
-
-  p = getenv("PATH");	/* get a pointer to the PATH env var.
-			   make a copy of it, since strtok modifies the
-			   string that it is working with... */
-  path = malloc((strlen(p)+1)*sizeof(char));	/* use malloc(3) */
-  strncpy(path, p, strlen(p));
-  path[strlen(p)] = '\0';
-
-  p = strtok(path, ":"); 	/* PATH is : delimited */
-  do				/* loop through the PATH */
-  {				/* to build a linked list of dirs */
-    if ( !pathlist )		/* create head of list */
-    {
-      tmp = calloc(1, sizeof(struct pathelement));
-      pathlist = tmp;
-    }
-    else			/* add on next element */
-    {
-      tmp->next = calloc(1, sizeof(struct pathelement));
-      tmp = tmp->next;
-    }
-    tmp->element = malloc(strlen(p)+1);	
-    strcpy(tmp->element, p);
-    tmp->next = NULL;
-
-  } while ( p = strtok(NULL, ":") );
-
-  free(path);      
-
-  return pathlist;
+  /* p is a temp pointer into PATH, strs is where the dir strings are copied */
+  char *p, *strs;
+  int count, len, i;
+
+  p = env_get("PATH");	/* get a pointer to the PATH env var */
+  if ( !p )
+    p = "";
+  len = strlen(p);
+
+  count = 1;		/* count the dirs to size the array */
+  for ( i = 0; p[i]; i++ )
+    if ( p[i] == ':' )
+      count++;
+
+  /* one block: the pointer array (plus its NULL) followed by the strings */
+  shell_path.dirs = malloc((count + 1) * sizeof(char *) + len + 1);
+  strs = (char *) (shell_path.dirs + count + 1);
+  memcpy(strs, p, len + 1);
+
+  shell_path.count = 0;
+  p = strs;
+  while ( *p )			/* loop through the PATH */
+  {				/* PATH is : delimited */
+    char *end = strchr(p, ':');
+    if ( end )
+      *end = '\0';
+    if ( *p )			/* skip empty components */
+      shell_path.dirs[shell_path.count++] = p;
+    if ( !end )
+      break;
+    p = end + 1;
+  }
+  shell_path.dirs[shell_path.count] = NULL;
+
+  parsed = 1;
+} /* end parse_path() */
+
+struct pathlist *get_path()
+{
+  if ( !parsed )
+    parse_path();
+  return &shell_path;
 } /* end get_path() */
+
+void update_path()
+{
+  if ( parsed )
+    free(shell_path.dirs);
+  parsed = 0;
+  parse_path();
+} /* end update_path() */
@@ -8,13 +8,42 @@
 #include <stdlib.h>
 #include <string.h>
 
-struct pathelement
+struct pathlist
 {
-  char *element;			/* a dir in the path */
-  struct pathelement *next;		/* pointer to next node */
+  char **dirs;		/* NULL terminated array of the dirs in the path */
+  int    count;		/* number of dirs in the path */
 };
 
-/* function prototype. 
-   It returns a pointer to a linked list for the path elements. */
-struct pathelement *get_path();
+/* function prototypes. 
+   get_path() returns the PATH of the shell, which is parsed only once.
+   update_path() parses PATH again after it was changed. */
+struct pathlist *get_path();
+void update_path();
 
+/* PATH is read from the environment variables of the shell
+   (see setenvvariables.c) */
+char *env_get(const char *name);
+
+/* index of the executables in PATH (see pathindex.c).
+   pathindex_contains() returns 1 if "name" is in dir number "dir" of
+   the PATH, 0 if it is not, and -1 if the dir is not indexed. */
+int pathindex_contains(int dir, const char *name);
+int pathindex_revalidate();
+void pathindex_reset();
+
+/* pathindex_names() calls "fn" for every executable of dir number "dir"
+   and returns how many there are, or -1 if the dir is not indexed.
+   pathindex_generation() changes whenever the index changes. */
+int pathindex_names(int dir, void (*fn)(const char *name, void *arg), void *arg);
+unsigned int pathindex_generation();
+
+/* matches of one name found by resolve_commands() (see where.c) */
+struct resolved
+{
+  char **paths;		/* NULL terminated, in PATH order */
+  int    count;
+  int    cap;
+};
+
+void resolve_commands(struct pathlist *p, char **names, int count, int first_only, struct resolved *res);
+void free_resolved(struct resolved *res, int count);
@@ -0,0 +1,182 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that remembers where external commands were found in PATH, so that PATH is searched ONLY once per command
+ *   - Commands that were NOT found are remembered too (negative cache), so a mistyped command doesn't search PATH again either
+ *   - The whole table is thrown away by rehash(), which happens on "rehash" and "hash -r" commands and whenever PATH is changed with "setenv"
+ *   - PATH is searched through the PATH index of "pathindex.c", and the table is also thrown away when the index
+ *     notices that a PATH directory changed, so a newly installed command is found without "rehash"
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sh.h"
+
+#define HASH_INITIAL_BUCKETS 64
+
+static unsigned int index_generation = 0;   // generation of the PATH index the table was filled from
+
+// Definition for an entry of the command hash table
+struct hash_entry {
+	char *name;               // name of the command as typed
+	char *path;               // full path of the command, or NULL if it was not found in PATH
+	int   hits;               // number of times this entry answered a lookup
+	struct hash_entry *next;  // next entry in the same bucket
+};
+
+static struct hash_entry **buckets = NULL;
+static int nbuckets = 0;
+static int nentries = 0;
+static long total_hits = 0, total_misses = 0;
+
+// djb2 string hash
+static unsigned long hash_string(const char *s){
+	unsigned long h = 5381;
+	while(*s)
+		h = h * 33 + (unsigned char) *s++;
+	return h;
+}
+
+// Doubles the number of buckets once the table is as full as it has buckets
+static void hash_grow(){
+	int new_nbuckets = nbuckets ? 2 * nbuckets : HASH_INITIAL_BUCKETS;
+	struct hash_entry **new_buckets = (struct hash_entry **) calloc(new_nbuckets, sizeof(struct hash_entry *));
+	struct hash_entry *e, *next;
+	int i;
+
+	for(i = 0; i < nbuckets; i++){
+		for(e = buckets[i]; e != NULL; e = next){
+			next = e->next;
+			e->next = new_buckets[hash_string(e->name) % new_nbuckets];
+			new_buckets[hash_string(e->name) % new_nbuckets] = e;
+		}
+	}
+	free(buckets);
+	buckets = new_buckets;
+	nbuckets = new_nbuckets;
+}
+
+// Throws away every remembered command
+static void hash_clear(){
+	struct hash_entry *e, *next;
+	int i;
+
+	for(i = 0; i < nbuckets; i++){
+		for(e = buckets[i]; e != NULL; e = next){
+			next = e->next;
+			free(e->name);
+			free(e->path);
+			free(e);
+		}
+		buckets[i] = NULL;
+	}
+	nentries = 0;
+}
+
+/*
+ * This function returns the full path of the given command from PATH, searching PATH ONLY if the command is not in the table yet
+ * Returns NULL if the command is not in PATH
+ * The returned string belongs to the table and stays valid until the next rehash()
+ */
+char *hash_lookup(char *command){
+	struct hash_entry *e;
+	unsigned long h = hash_string(command);
+
+	// A PATH directory changed: any remembered answer, even "not found", may be wrong now
+	// The generation is compared, because the completion of the line editor may be the one that noticed the change
+	pathindex_revalidate();
+	if(pathindex_generation() != index_generation){
+		hash_clear();
+		index_generation = pathindex_generation();
+	}
+
+	if(nbuckets){
+		for(e = buckets[h % nbuckets]; e != NULL; e = e->next){
+			if(strcmp(e->name, command) == 0){
+				e->hits++;
+				total_hits++;
+				return e->path;
+			}
+		}
+	}
+
+	// Not in the table, so search PATH through which(...) and remember the answer (even if it is "not found")
+	total_misses++;
+	if(nentries >= nbuckets)
+		hash_grow();
+
+	e = (struct hash_entry *) malloc(sizeof(struct hash_entry));
+	e->name = strdup(command);
+	e->path = which(command, get_path());
+	e->hits = 0;
+	e->next = buckets[h % nbuckets];
+	buckets[h % nbuckets] = e;
+	nentries++;
+
+	return e->path;
+}
+
+/*
+ * This function throws away every remembered command and the PATH index, so that the next lookups read the PATH directories again
+ * The hits and misses of the whole table are kept, ONLY hash_reset_counters(...) clears them
+ */
+void rehash(){
+	hash_clear();
+	pathindex_reset();
+}
+
+/*
+ * This function clears the hits and misses of the whole table, for "rehash" and "hash -r" commands
+ */
+void hash_reset_counters(){
+	total_hits = total_misses = 0;
+}
+
+/*
+ * This is the helper function for implementing "hash" command
+ * It prints every remembered command with its number of hits, followed by the hits and misses of the whole table
+ */
+void hash_print(){
+	struct hash_entry *e;
+	int i;
+
+	if(nentries == 0)
+		out_str(&shell_out, "hash: hash table empty\n");
+	else{
+		out_str(&shell_out, "hits\tcommand\n");
+		for(i = 0; i < nbuckets; i++){
+			for(e = buckets[i]; e != NULL; e = e->next){
+				if(e->path)
+					out_printf(&shell_out, "%4d\t%s\n", e->hits, e->path);
+				else
+					out_printf(&shell_out, "%4d\t%s (not found)\n", e->hits, e->name);
+			}
+		}
+	}
+	out_printf(&shell_out, "%ld hits, %ld misses\n", total_hits, total_misses);
+}
+
+/*
+ * This function finds the executable to run for the given command name
+ *   - A name with a "/" in it is already a path to the executable
+ *   - Otherwise PATH is searched through the table, and lastly the current directory is tried as well
+ * Returns NULL if there is no such executable
+ */
+char *find_command(char *command){
+	char *excmd;
+
+	if(strchr(command, '/') != NULL)
+		return access(command, X_OK) == 0 ? command : NULL;
+
+	if((excmd = hash_lookup(command)) != NULL)
+		return excmd;
+
+	// Check if the file exist AND if that file is executable in the current directory
+	if(access(command, F_OK) == 0 && access(command, X_OK) == 0)
+		return command;
+
+	return NULL;
+}
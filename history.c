@@ -0,0 +1,486 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that implements the command history of our Shell
+ *   - Every command line typed at the prompt is appended to "$HOME/.mysh_history" as ONE record (time, current directory,
+ *     duration, exit status and the line itself), written with ONE write(...) on a file opened with O_APPEND,
+ *     so several shells can append to the same file at the same time without mixing their records up
+ *   - At startup the file is mapped with mmap(...) and its records are put into a ring buffer of the last HISTORY_MAX
+ *     command lines, pointing straight into the mapping, so nothing is copied
+ *   - "history", "!!", "!n", "!-n" and "!prefix" use the ring buffer
+ *   - The incremental search (CTRL-R) and "!prefix" go through a trigram index: for every 3 characters in a row, the list
+ *     of command lines that contain them; a search ONLY looks at the lines of its rarest trigram
+ *     A long history is indexed by a thread started at startup (until it is done, a search looks at the lines one by one),
+ *     a short one the first time a search needs it; the command lines added afterwards are indexed by the next search
+ */
+
+#define _GNU_SOURCE
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "sh.h"
+
+#define HISTORY_MAX  (1 << 20)    // command lines kept in memory, a power of 2
+#define HIST_MAGIC   0x5453484dU  // "MHST"
+#define ANCHOR       '\001'       // start of a line, for the trigrams of "!prefix"
+#define BUILD_THREAD 10000        // a history file of at least this many command lines is indexed by a thread
+
+/*
+ * ONE record of the history file, followed by the current directory and the command line (both NUL terminated)
+ * and padded to a multiple of 8 bytes
+ */
+struct hist_record {
+	uint32_t magic;
+	uint32_t size;          // size of the whole record
+	int64_t  time;          // when the command line was started
+	int32_t  duration_ms;
+	int32_t  status;        // exit status of the command line
+	uint32_t cwdlen;        // including the NUL
+	uint32_t linelen;       // including the NUL
+};
+
+// ONE command line of the ring buffer
+struct hist_entry {
+	const char *line;
+	const char *cwd;
+	int64_t     time;
+	int32_t     duration_ms;
+	int32_t     status;
+	int         owned;      // "line" was allocated (with "cwd" in the same block), otherwise both are in the mapped file
+};
+
+static struct hist_entry *ring = NULL;
+static long ring_cap = 0;
+static long first_seq = 1;     // number of the oldest command line in the ring buffer
+static long last_seq = 0;      // number of the newest one, 0 if there is none yet
+static int  hist_fd = -1;      // history file, opened with O_APPEND
+
+#define ENTRY(seq)  (&ring[((seq) - 1) & (ring_cap - 1)])
+
+// Trigram index: for each trigram, the numbers of the command lines that contain it, in increasing order
+struct posting {
+	uint32_t  key;          // the 3 characters, 0 for an empty slot
+	uint32_t  n;
+	uint32_t  cap;
+	uint32_t *seqs;
+};
+
+static struct posting *tri = NULL;
+static size_t tri_cap = 0, tri_count = 0;
+static long tri_upto = 0;      // the command lines up to this number are in the index
+static int  tri_built = 0;     // set once the main thread owns the index
+
+// The thread that indexes the history file gets its own copy of the line pointers (into the mapping, never freed)
+static pthread_t    builder;
+static int          building = 0;
+static atomic_int   builder_done;
+static const char **snapshot;
+static long         snap_first, snap_last;
+
+/*
+ * Adds a command line to the ring buffer, overwriting the oldest one once the ring buffer is full
+ */
+static void ring_add(const char *line, const char *cwd, int64_t time, int32_t duration_ms, int32_t status, int owned){
+	struct hist_entry *e;
+
+	if(last_seq - first_seq + 1 == ring_cap){
+		if(ring_cap < HISTORY_MAX){
+			// Before it is full the first time, the ring buffer is just an array that grows
+			ring_cap = ring_cap ? 2 * ring_cap : 1024;
+			ring = (struct hist_entry *) realloc(ring, sizeof(struct hist_entry) * ring_cap);
+		}
+		else{
+			e = ENTRY(first_seq);
+			if(e->owned)
+				free((char *) e->line);
+			first_seq++;
+		}
+	}
+
+	last_seq++;
+	e = ENTRY(last_seq);
+	e->line = line;
+	e->cwd = cwd;
+	e->time = time;
+	e->duration_ms = duration_ms;
+	e->status = status;
+	e->owned = owned;
+}
+
+static uint32_t trigram(const char *s){
+	return ((uint32_t) (unsigned char) s[0] << 16) | ((uint32_t) (unsigned char) s[1] << 8) | (unsigned char) s[2];
+}
+
+// Finds the slot of the trigram in the index (an empty slot if it is not there)
+// The index must have slots (tri_cap > 0): a search checks tri_count first
+static struct posting *tri_slot(uint32_t key){
+	size_t i = (key * 2654435761U) & (tri_cap - 1);
+
+	while(tri[i].key != 0 && tri[i].key != key)
+		i = (i + 1) & (tri_cap - 1);
+	return &tri[i];
+}
+
+static void tri_grow(){
+	struct posting *old = tri;
+	size_t old_cap = tri_cap, i;
+
+	tri_cap = tri_cap ? 2 * tri_cap : 4096;
+	tri = (struct posting *) calloc(tri_cap, sizeof(struct posting));
+	for(i = 0; i < old_cap; i++)
+		if(old[i].key != 0)
+			*tri_slot(old[i].key) = old[i];
+	free(old);
+}
+
+// Adds ONE trigram of a command line to the index
+static void tri_put(long seq, const char *s){
+	struct posting *p;
+
+	if(2 * (tri_count + 1) > tri_cap)
+		tri_grow();
+	p = tri_slot(trigram(s));
+	if(p->key == 0){
+		p->key = trigram(s);
+		tri_count++;
+	}
+
+	// A trigram that appears twice in the same line is added ONCE
+	if(p->n > 0 && p->seqs[p->n - 1] == (uint32_t) seq)
+		return;
+	if(p->n == p->cap){
+		p->cap = p->cap ? 2 * p->cap : 4;
+		p->seqs = (uint32_t *) realloc(p->seqs, sizeof(uint32_t) * p->cap);
+	}
+	p->seqs[p->n++] = (uint32_t) seq;
+}
+
+// Adds every trigram of the command line to the index
+static void tri_add(long seq, const char *line){
+	char first[3];
+	size_t i, len = strlen(line);
+
+	// The line starts with ANCHOR, so "!prefix" can find the lines that START with the prefix
+	if(len >= 2){
+		first[0] = ANCHOR;
+		first[1] = line[0];
+		first[2] = line[1];
+		tri_put(seq, first);
+	}
+	for(i = 0; i + 3 <= len; i++)
+		tri_put(seq, line + i);
+}
+
+// Indexes the command lines of the history file, while the shell goes on
+static void *tri_builder(void *unused){
+	long seq;
+
+	for(seq = snap_first; seq <= snap_last; seq++)
+		tri_add(seq, snapshot[seq - snap_first]);
+	atomic_store(&builder_done, 1);
+	return unused;
+}
+
+/*
+ * Makes the index ready for a search: takes it over from the thread once it is done, and adds the newer command lines
+ * Returns 0 if the thread is still working, then the search can't use the index yet
+ */
+static int tri_ready(){
+	long seq;
+
+	if(!tri_built){
+		if(building){
+			if(!atomic_load(&builder_done))
+				return 0;
+			pthread_join(builder, NULL);
+			free(snapshot);
+			building = 0;
+			tri_upto = snap_last;
+		}
+		tri_built = 1;
+	}
+
+	for(seq = tri_upto + 1 > first_seq ? tri_upto + 1 : first_seq; seq <= last_seq; seq++)
+		tri_add(seq, ENTRY(seq)->line);
+	tri_upto = last_seq;
+	return 1;
+}
+
+/*
+ * This function opens the history file and loads it into the ring buffer
+ * It is called ONLY by the interactive shell, scripts have no history
+ */
+void history_init(){
+	char *home = env_get("HOME"), path[PATH_MAX];
+	struct stat st;
+	char *map;
+	size_t off;
+
+	if(home == NULL)
+		return;
+	snprintf(path, sizeof(path), "%s/.mysh_history", home);
+	if((hist_fd = open(path, O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR)) < 0)
+		return;
+	if(fstat(hist_fd, &st) != 0 || st.st_size == 0)
+		return;
+
+	// The mapping is never unmapped: the ring buffer points into it
+	map = (char *) mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, hist_fd, 0);
+	if(map == MAP_FAILED)
+		return;
+
+	for(off = 0; off + sizeof(struct hist_record) <= (size_t) st.st_size; ){
+		struct hist_record *r = (struct hist_record *) (map + off);
+		const char *cwd, *line;
+
+		// A record cut short (a shell killed in the middle of a write) is skipped up to the next record
+		if(r->magic != HIST_MAGIC || r->size % 8 != 0 || r->size < sizeof(struct hist_record) || off + r->size > (size_t) st.st_size ||
+		   sizeof(struct hist_record) + (size_t) r->cwdlen + r->linelen > r->size || r->cwdlen == 0 || r->linelen == 0){
+			off += 8;
+			continue;
+		}
+		cwd = map + off + sizeof(struct hist_record);
+		line = cwd + r->cwdlen;
+		if(cwd[r->cwdlen - 1] == '\0' && line[r->linelen - 1] == '\0')
+			ring_add(line, cwd, r->time, r->duration_ms, r->status, 0);
+		off += r->size;
+	}
+
+	// A long history is indexed by a thread, so the first CTRL-R doesn't have to wait for it
+	if(last_seq - first_seq + 1 >= BUILD_THREAD){
+		snap_first = first_seq;
+		snap_last = last_seq;
+		snapshot = (const char **) malloc(sizeof(char *) * (snap_last - snap_first + 1));
+		for(off = 0; off < (size_t) (snap_last - snap_first + 1); off++)
+			snapshot[off] = ENTRY(snap_first + (long) off)->line;
+		if(pthread_create(&builder, NULL, tri_builder, NULL) == 0)
+			building = 1;
+		else
+			free(snapshot);
+	}
+}
+
+/*
+ * This function adds a command line to the history and appends it to the history file
+ * "started" is when it started, "duration_ms" how long it took and "status" its exit status
+ */
+void history_add(const char *line, time_t started, long duration_ms, int status){
+	struct hist_record r;
+	char *cwd = getcwd(NULL, 0), *copy, *rec;
+	size_t linelen = strlen(line) + 1, cwdlen;
+
+	if(cwd == NULL)
+		cwd = strdup("");
+	cwdlen = strlen(cwd) + 1;
+
+	// The line and the directory are kept in ONE block
+	copy = (char *) malloc(linelen + cwdlen);
+	memcpy(copy, line, linelen);
+	memcpy(copy + linelen, cwd, cwdlen);
+	ring_add(copy, copy + linelen, started, (int32_t) duration_ms, status, 1);
+
+	// ONE write(...) of the whole record with O_APPEND: another shell can't write into the middle of it
+	if(hist_fd != -1){
+		memset(&r, 0, sizeof(r));
+		r.magic = HIST_MAGIC;
+		r.size = (sizeof(r) + cwdlen + linelen + 7) & ~7U;
+		r.time = started;
+		r.duration_ms = (int32_t) duration_ms;
+		r.status = status;
+		r.cwdlen = cwdlen;
+		r.linelen = linelen;
+
+		rec = (char *) calloc(1, r.size);
+		memcpy(rec, &r, sizeof(r));
+		memcpy(rec + sizeof(r), cwd, cwdlen);
+		memcpy(rec + sizeof(r) + cwdlen, line, linelen);
+		if(write(hist_fd, rec, r.size) != (ssize_t) r.size)
+			fprintf(stderr, "history: %s.\n", strerror(errno));
+		free(rec);
+	}
+	free(cwd);
+}
+
+// Numbers of the oldest and the newest command line, and the command line of a number (NULL if it is not kept)
+long history_first(){
+	return first_seq;
+}
+
+long history_last(){
+	return last_seq;
+}
+
+const char *history_line(long seq){
+	if(seq < first_seq || seq > last_seq)
+		return NULL;
+	return ENTRY(seq)->line;
+}
+
+/*
+ * This function finds the newest command line BEFORE number "before" that contains "query" (or starts with it, with "anchored")
+ * Returns its number, or 0 if there is none
+ */
+long history_search(const char *query, long before, int anchored){
+	char *pattern;
+	struct posting *p, *rarest = NULL;
+	size_t len = strlen(query), i;
+	long seq, lo, hi, mid, found = 0;
+
+	if(before > last_seq + 1)
+		before = last_seq + 1;
+
+	// Too short for a trigram (or the index is not ready yet): the command lines are looked at one by one, newest first
+	if(len + (anchored ? 1 : 0) < 3 || !tri_ready()){
+		for(seq = before - 1; seq >= first_seq; seq--){
+			const char *line = ENTRY(seq)->line;
+			if(anchored ? strncmp(line, query, len) == 0 : strstr(line, query) != NULL)
+				return seq;
+		}
+		return 0;
+	}
+
+	// No command line has a trigram yet (all of them are shorter than 2 characters, or there are none),
+	// so the index has no slots at all and no line can contain the query
+	if(tri_count == 0)
+		return 0;
+
+	pattern = (char *) malloc(len + 2);
+	sprintf(pattern, "%s%s", anchored ? "\001" : "", query);
+
+	// Every trigram of the query has to be in the line, so ONLY the lines of the rarest one are looked at
+	for(i = 0; i + 3 <= strlen(pattern); i++){
+		p = tri_slot(trigram(pattern + i));
+		if(p->key == 0){
+			free(pattern);
+			return 0;
+		}
+		if(rarest == NULL || p->n < rarest->n)
+			rarest = p;
+	}
+	free(pattern);
+
+	// The numbers are in increasing order: find the last one before "before" and go back from there
+	lo = 0;
+	hi = (long) rarest->n;
+	while(lo < hi){
+		mid = lo + (hi - lo) / 2;
+		if((long) rarest->seqs[mid] < before)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	for(mid = lo - 1; mid >= 0; mid--){
+		const char *line;
+
+		seq = rarest->seqs[mid];
+		if(seq < first_seq)
+			break;        // older ones are not kept anymore
+		line = ENTRY(seq)->line;
+		if(anchored ? strncmp(line, query, len) == 0 : strstr(line, query) != NULL){
+			found = seq;
+			break;
+		}
+	}
+	return found;
+}
+
+/*
+ * This function replaces the history references of the command line with the command lines they refer to
+ *   "!!" the last command line, "!n" command line number n, "!-n" the n-th last one, "!prefix" the last one starting with prefix
+ * A "!" inside single quotes, or followed by a blank or "=", is left as it is
+ * Returns the new command line (allocated), or NULL if a reference was not found (the error message is already printed)
+ */
+char *history_expand(const char *line){
+	size_t cap = strlen(line) + 64, len = 0, n;
+	char *out = (char *) malloc(cap), *word;
+	const char *p, *end, *event;
+	int quoted = 0;
+	long seq;
+
+	for(p = line; *p; ){
+		event = NULL;
+		end = p + 1;
+
+		if(*p == '\'')
+			quoted = !quoted;
+		else if(*p == '\\' && p[1] && !quoted){
+			// A backslash keeps the next character (and the backslash) as it is
+			end = p + 2;
+		}
+		else if(*p == '!' && !quoted && p[1] && !isspace((unsigned char) p[1]) && p[1] != '='){
+			if(p[1] == '!'){
+				seq = last_seq;
+				end = p + 2;
+			}
+			else if(isdigit((unsigned char) p[1]) || (p[1] == '-' && isdigit((unsigned char) p[2]))){
+				seq = strtol(p + 1, (char **) &end, 10);
+				if(seq < 0)
+					seq = last_seq + 1 + seq;
+			}
+			else{
+				// "!prefix": the prefix ends at a blank or at an operator
+				for(end = p + 1; *end && !isspace((unsigned char) *end) && !strchr(";|&<>", *end); end++);
+				word = strndup(p + 1, end - (p + 1));
+				seq = history_search(word, last_seq + 1, 1);
+				free(word);
+			}
+
+			if((event = history_line(seq)) == NULL){
+				fprintf(stderr, "%.*s: Event not found.\n", (int) (end - p), p);
+				free(out);
+				return NULL;
+			}
+		}
+
+		n = event ? strlen(event) : (size_t) (end - p);
+		if(len + n + 1 > cap){
+			while(len + n + 1 > cap)
+				cap *= 2;
+			out = (char *) realloc(out, cap);
+		}
+		memcpy(out + len, event ? event : p, n);
+		len += n;
+		p = end;
+	}
+	out[len] = '\0';
+	return out;
+}
+
+/*
+ * This is the helper function for implementing "history" command
+ * It prints the last "count" command lines (all of them if "count" is 0), and with "verbose" when, where and how they ran
+ */
+void history_print(long count, int verbose){
+	struct hist_entry *e;
+	struct tm tm;
+	char when[32];
+	time_t t;
+	long seq;
+
+	seq = count > 0 && last_seq - count + 1 > first_seq ? last_seq - count + 1 : first_seq;
+	for( ; seq <= last_seq; seq++){
+		e = ENTRY(seq);
+		if(!verbose){
+			out_printf(&shell_out, "%6ld  %s\n", seq, e->line);
+			continue;
+		}
+		t = (time_t) e->time;
+		localtime_r(&t, &tm);
+		strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &tm);
+		out_printf(&shell_out, "%6ld  %s  %6.3fs  [%d]  %s  %s\n", seq, when, e->duration_ms / 1000.0, e->status, e->cwd, e->line);
+	}
+}
@@ -0,0 +1,177 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that reads the command lines of our Shell
+ *   - Input is read with read(...) in blocks of READER_BUFSIZE bytes and split into lines by the shell itself,
+ *     so a script of thousands of lines takes a handful of system calls instead of one per line
+ *   - A line can be of ANY length, the buffers grow as needed
+ *   - reader_take_line(...) and reader_fill(...) let the event loop of "event.c" read the input ONLY when it is ready
+ *   - A reader can also be made from a string (for "mysh -c 'command'")
+ *   - A built-in command that reads a line of STDIN ("prompt") reads it through the reader of STDIN with reader_stdin_line(...):
+ *     the reader may have read the following lines ahead already, where stdio would never see them
+ */
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "sh.h"
+
+#define READER_BUFSIZE 65536
+
+// The reader of the command lines when they come from STDIN, and the file STDIN was then (NULL if they don't)
+static struct reader *stdin_reader = NULL;
+static struct stat stdin_file;
+
+/*
+ * This function sets up a reader on the given file descriptor
+ */
+void reader_init(struct reader *rd, int fd){
+	rd->fd    = fd;
+	rd->cap   = READER_BUFSIZE;
+	rd->buf   = (char *) malloc(rd->cap);
+	rd->start = rd->end = 0;
+	rd->line  = NULL;
+	rd->linecap = 0;
+
+	if(fd == STDIN_FILENO && fstat(fd, &stdin_file) == 0)
+		stdin_reader = rd;
+}
+
+/*
+ * This function sets up a reader on the given string, no file descriptor is read at all
+ */
+void reader_init_string(struct reader *rd, const char *text){
+	rd->fd    = -1;
+	rd->cap   = strlen(text) + 1;
+	rd->buf   = strdup(text);
+	rd->start = 0;
+	rd->end   = rd->cap - 1;
+	rd->line  = NULL;
+	rd->linecap = 0;
+}
+
+/*
+ * This function takes the next complete line out of the buffer, or NULL if the buffer has no newline yet
+ * At end of input ("at_eof"), whatever is left in the buffer is the last line even without a newline
+ * The returned line belongs to the reader and stays valid until the next call
+ */
+char *reader_take_line(struct reader *rd, int at_eof){
+	char *nl;
+	size_t n;
+
+	nl = memchr(rd->buf + rd->start, '\n', rd->end - rd->start);
+	if(nl == NULL && (!at_eof || rd->end == rd->start))
+		return NULL;
+	n = (nl ? (size_t) (nl - rd->buf) : rd->end) - rd->start;
+
+	if(n + 1 > rd->linecap){
+		rd->linecap = rd->linecap ? rd->linecap : 256;
+		while(n + 1 > rd->linecap)
+			rd->linecap *= 2;
+		rd->line = (char *) realloc(rd->line, rd->linecap);
+	}
+	memcpy(rd->line, rd->buf + rd->start, n);
+	rd->line[n] = '\0';
+	rd->start += n + (nl != NULL);   // the newline is skipped
+	return rd->line;
+}
+
+/*
+ * This function reads the next block of input into the buffer with ONE read(...)
+ * The unread part of the buffer is moved to its beginning first, and the buffer grows if a line doesn't fit into it
+ * Returns what read(...) returned: the number of bytes, 0 on end of input or -1 on error
+ */
+ssize_t reader_fill(struct reader *rd){
+	ssize_t got;
+
+	if(rd->fd == -1)
+		return 0;
+
+	if(rd->start > 0){
+		memmove(rd->buf, rd->buf + rd->start, rd->end - rd->start);
+		rd->end -= rd->start;
+		rd->start = 0;
+	}
+	if(rd->end == rd->cap){
+		rd->cap *= 2;
+		rd->buf = (char *) realloc(rd->buf, rd->cap);
+	}
+
+	got = read(rd->fd, rd->buf + rd->end, rd->cap - rd->end);
+	if(got > 0)
+		rd->end += got;
+	return got;
+}
+
+/*
+ * This function throws away the input that is not a complete line yet (CTRL-C at the prompt)
+ */
+void reader_discard(struct reader *rd){
+	rd->start = rd->end = 0;
+}
+
+/*
+ * This function returns the next line without its newline character, or NULL on end of input
+ * The returned line belongs to the reader and stays valid until the next call
+ * A reader on a terminal can be read again after end of input (the user pressed CTRL-D)
+ */
+char *read_line(struct reader *rd){
+	char *line;
+	ssize_t got;
+
+	while((line = reader_take_line(rd, 0)) == NULL){
+		got = reader_fill(rd);
+		if(got < 0 && errno == EINTR)
+			continue;
+
+		// End of input: the last line may not have a newline at its end
+		if(got <= 0)
+			return reader_take_line(rd, 1);
+	}
+	return line;
+}
+
+/*
+ * This function frees the buffers of the reader (the file descriptor is NOT closed)
+ */
+void reader_free(struct reader *rd){
+	if(rd == stdin_reader)
+		stdin_reader = NULL;
+	free(rd->buf);
+	free(rd->line);
+	rd->buf = rd->line = NULL;
+	rd->start = rd->end = rd->cap = rd->linecap = 0;
+}
+
+/*
+ * This function reads ONE line of STDIN for a built-in command into "buf" (at most "size" - 1 bytes), without its newline
+ * While STDIN is still the input of the shell, the line comes from the reader of the command lines, so the lines it read ahead
+ * are not skipped; a redirected STDIN ("prompt < file") or the STDIN of a script is read with stdio
+ * Returns 0 at end of input
+ */
+int reader_stdin_line(char *buf, size_t size){
+	struct stat st;
+	char *line;
+	size_t len;
+
+	if(stdin_reader != NULL && fstat(STDIN_FILENO, &st) == 0 && st.st_dev == stdin_file.st_dev && st.st_ino == stdin_file.st_ino){
+		if((line = read_line(stdin_reader)) == NULL)
+			return 0;
+		strncpy(buf, line, size - 1);
+		buf[size - 1] = '\0';
+		return 1;
+	}
+
+	if(fgets(buf, size, stdin) == NULL)
+		return 0;
+	len = strlen(buf);
+	if(len > 0 && buf[len - 1] == '\n')
+		buf[len - 1] = '\0';
+	return 1;
+}
@@ -0,0 +1,489 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that keeps the job table of our Shell
+ *   - Every pipeline of external commands is a job: its PIDs, its process group, its state, when it started and its exit status
+ *   - Children are reaped ONLY here, with wait4(...) called by the shell itself (there is no SIGCHLD handler anymore),
+ *     so a background job can never take the exit status of the job the shell is waiting for
+ *   - wait4(...) also gives what each child used (CPU time, max RSS, page faults, context switches), which is added up
+ *     in the job for the "time" prefix, whose report is printed when the job is removed
+ *   - Background jobs that finished are reported before the next prompt by jobs_notify(...)
+ *   - With job control (interactive shell), every job gets its own process group and the foreground job gets the terminal,
+ *     so CTRL-C and CTRL-Z go to the job and not to the shell
+ */
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include "sh.h"
+
+// States of a process of a job
+#define PROC_RUNNING 0
+#define PROC_STOPPED 1
+#define PROC_DONE    2
+
+// A script keeps at most this many finished jobs for "wait %n", like CHILD_MAX in bash,
+// so a script that starts "cmd &" in a loop does not grow the job table forever
+#define DONE_JOBS_MAX 1024
+
+int job_control = 0;              // set if jobs get their own process group and the terminal (interactive shell)
+static pid_t shell_pgid;          // process group of the shell, it gets the terminal back after a foreground job
+
+static struct job *job_list = NULL;   // jobs in the order they were started
+
+static const char *state_names[] = { "Running", "Stopped", "Done" };
+
+/*
+ * This function turns job control on: the shell takes its own process group and the terminal
+ * The shell ignores SIGTTOU and SIGTTIN, so it can give the terminal to a job and take it back
+ */
+void jobs_init(){
+	job_control = 1;
+	signal(SIGTTOU, SIG_IGN);
+	signal(SIGTTIN, SIG_IGN);
+
+	shell_pgid = getpid();
+	if(getpgrp() != shell_pgid)
+		setpgid(0, shell_pgid);
+	tcsetpgrp(STDIN_FILENO, shell_pgid);
+}
+
+// Builds the text of a pipeline for "jobs", e.g. "sort < in | uniq -c &"
+static char *pipeline_text(struct pipeline *pl){
+	static const char *ops[] = { "<", ">", ">>", ">&" };
+	struct command *cmd;
+	struct redirection *r;
+	size_t len = 1;
+	char *text;
+	int i;
+
+	for(cmd = pl->commands; cmd != NULL; cmd = cmd->next){
+		for(i = 0; i < cmd->argc; i++)
+			len += strlen(cmd->argv[i]) + 1;
+		for(r = cmd->redirs; r != NULL; r = r->next)
+			len += strlen(r->file) + 16;
+		len += 4;
+	}
+
+	text = (char *) malloc(len);
+	text[0] = '\0';
+	for(cmd = pl->commands; cmd != NULL; cmd = cmd->next){
+		for(i = 0; i < cmd->argc; i++){
+			if(i > 0)
+				strcat(text, " ");
+			strcat(text, cmd->argv[i]);
+		}
+		for(r = cmd->redirs; r != NULL; r = r->next){
+			char redir[16];
+			if(r->kind == REDIR_DUP)
+				sprintf(redir, " %d>&", r->fd);
+			else if(r->fd != (r->kind == REDIR_IN ? 0 : 1))
+				sprintf(redir, " %d%s", r->fd, ops[r->kind]);
+			else
+				sprintf(redir, " %s", r->also_stderr ? (r->kind == REDIR_OUT ? ">&" : ">>&") : ops[r->kind]);
+			strcat(text, redir);
+			strcat(text, r->kind == REDIR_DUP ? "" : " ");
+			strcat(text, r->file);
+		}
+		if(cmd->next)
+			strcat(text, cmd->stderr_to_pipe ? " |& " : " | ");
+	}
+	return text;
+}
+
+/*
+ * This function adds a new job for the given pipeline to the job table
+ * The job gets the lowest job number that is not used
+ */
+struct job *job_add(struct pipeline *pl){
+	struct job *job, **tail;
+	int id = 1;
+
+	// The job numbers are kept increasing along the list, so the first gap is the lowest free number
+	for(tail = &job_list; *tail != NULL && (*tail)->id == id; tail = &(*tail)->next)
+		id++;
+
+	job = (struct job *) calloc(1, sizeof(struct job));
+	job->id    = id;
+	job->pgid  = 0;
+	job->pids  = (pid_t *) malloc(sizeof(pid_t) * pl->ncommands);
+	job->pstate = (int *) malloc(sizeof(int) * pl->ncommands);
+	job->pidfds = (int *) malloc(sizeof(int) * pl->ncommands);
+	job->state = JOB_RUNNING;
+	job->background = pl->background;
+	job->starting = 1;
+	job->timed = pl->timed;
+	job->text  = pipeline_text(pl);
+	clock_gettime(CLOCK_MONOTONIC, &job->started);
+
+	job->next = *tail;
+	*tail = job;
+	return job;
+}
+
+/*
+ * This function adds a started process to the job, the first one also gives the process group of the job
+ * The event loop of "event.c" gets a pidfd for the process, so it wakes up as soon as the process exits
+ */
+void job_add_pid(struct job *job, pid_t pid){
+	if(job->npids == 0)
+		job->pgid = pid;
+	job->pids[job->npids] = pid;
+	job->pstate[job->npids] = PROC_RUNNING;
+	job->pidfds[job->npids] = event_watch_child(pid);
+	job->npids++;
+}
+
+// Closes the pidfd of a process of the job, which also takes it out of the event loop
+static void job_close_pidfd(struct job *job, int i){
+	if(job->pidfds[i] != -1){
+		close(job->pidfds[i]);
+		job->pidfds[i] = -1;
+	}
+}
+
+/*
+ * This function removes the job from the job table and frees it
+ * A job started with "time" prints its report here, once all of it is done
+ */
+void job_remove(struct job *job){
+	struct job **indirect;
+
+	// A job without processes (ONLY built-in commands run in the shell) finishes now
+	if(job->timed){
+		if(job->finished.tv_sec == 0 && job->finished.tv_nsec == 0)
+			clock_gettime(CLOCK_MONOTONIC, &job->finished);
+		time_report(job->timed, &job->started, &job->finished, &job->usage);
+	}
+
+	for(indirect = &job_list; *indirect != NULL; indirect = &(*indirect)->next){
+		if(*indirect == job){
+			*indirect = job->next;
+			break;
+		}
+	}
+	for(int i = 0; i < job->npids; i++)
+		job_close_pidfd(job, i);
+	free(job->pids);
+	free(job->pstate);
+	free(job->pidfds);
+	free(job->text);
+	free(job);
+}
+
+// Works out the state of the job from the states of its processes
+static void job_update_state(struct job *job){
+	int i, running = 0, stopped = 0;
+
+	for(i = 0; i < job->npids; i++){
+		if(job->pstate[i] == PROC_RUNNING)
+			running++;
+		else if(job->pstate[i] == PROC_STOPPED)
+			stopped++;
+	}
+	if(running)
+		job->state = JOB_RUNNING;
+	else if(stopped)
+		job->state = JOB_STOPPED;
+	else{
+		// When it finished, for "time"
+		if(job->state != JOB_DONE)
+			clock_gettime(CLOCK_MONOTONIC, &job->finished);
+		job->state = JOB_DONE;
+	}
+}
+
+/*
+ * This function records the status and the usage that wait4(...) gave for the given PID in the job it belongs to
+ * The exit status of a job is the one of its last process
+ */
+static void job_record(pid_t pid, int status, struct rusage *ru){
+	struct job *job;
+	int i;
+
+	for(job = job_list; job != NULL; job = job->next){
+		for(i = 0; i < job->npids; i++){
+			if(job->pids[i] != pid)
+				continue;
+
+			if(WIFSTOPPED(status))
+				job->pstate[i] = PROC_STOPPED;
+			else if(WIFCONTINUED(status))
+				job->pstate[i] = PROC_RUNNING;
+			else{
+				job->pstate[i] = PROC_DONE;
+				job_close_pidfd(job, i);
+				rusage_add(&job->usage, ru);
+				if(i == job->npids - 1)
+					job->status = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+			}
+			job_update_state(job);
+			return;
+		}
+	}
+}
+
+/*
+ * This function collects the status of every child that changed state, without waiting
+ */
+void jobs_reap(){
+	struct rusage ru;
+	pid_t pid;
+	int status;
+
+	while((pid = wait4(-1, &status, WNOHANG | WUNTRACED | WCONTINUED, &ru)) > 0)
+		job_record(pid, status, &ru);
+}
+
+/*
+ * This function waits until the given job is done (or stopped, with job control)
+ * Any other child that changes state in the meantime is recorded in its own job
+ * Returns the exit status of the job
+ */
+int job_wait(struct job *job){
+	struct rusage ru;
+	pid_t pid;
+	int status;
+
+	// Nothing to wait for if none of the commands of the job could be started
+	if(job->npids == 0)
+		job->state = JOB_DONE;
+
+	while(job->state == JOB_RUNNING){
+		pid = wait4(-1, &status, job_control ? WUNTRACED : 0, &ru);
+		if(pid < 0){
+			if(errno == EINTR)
+				continue;
+
+			// No children are left, so whatever was not reaped is gone
+			break;
+		}
+		job_record(pid, status, &ru);
+	}
+	return job->status;
+}
+
+// Sends SIGCONT to every process of a stopped job
+static void job_continue(struct job *job){
+	int i;
+
+	for(i = 0; i < job->npids; i++){
+		if(job->pstate[i] == PROC_STOPPED){
+			job->pstate[i] = PROC_RUNNING;
+			if(!job_control)
+				kill(job->pids[i], SIGCONT);
+		}
+	}
+	job->state = JOB_RUNNING;
+
+	// With job control, the whole process group gets the signal at once
+	if(job_control)
+		kill(-job->pgid, SIGCONT);
+}
+
+/*
+ * This function runs the job in foreground: it gets the terminal, and the shell waits for it
+ *   - A job that is done is removed from the job table
+ *   - A job that is stopped (CTRL-Z) stays in the job table, and the shell takes the terminal back
+ * "cont" sends SIGCONT to the job first (for "fg")
+ * Returns the exit status of the job, or 128 + SIGTSTP if it was stopped
+ */
+int job_foreground(struct job *job, int cont){
+	int status;
+
+	job->background = 0;
+	if(job_control && job->pgid > 0)
+		tcsetpgrp(STDIN_FILENO, job->pgid);
+
+	if(cont)
+		job_continue(job);
+
+	status = job_wait(job);
+
+	if(job_control)
+		tcsetpgrp(STDIN_FILENO, shell_pgid);
+
+	if(job->state == JOB_STOPPED){
+		printf("\n[%d]+  Stopped\t\t%s\n", job->id, job->text);
+		job->notified = 1;
+		return 128 + SIGTSTP;
+	}
+
+	// The "^C" of the terminal is left on the line of the job
+	if(job_control && status == 128 + SIGINT)
+		printf("\n");
+	job_remove(job);
+	return status;
+}
+
+/*
+ * This function finds a job from an argument of "fg", "bg" or "wait": "%n" or "n" is job number n
+ * Without an argument, it is the most recently started job
+ * Returns NULL (and prints an error message) if there is no such job
+ */
+struct job *job_find(char *name, char *builtin){
+	struct job *job;
+	int id;
+
+	if(name == NULL){
+		if((job = job_find_quiet()) == NULL)
+			fprintf(stderr, "%s: No current job.\n", builtin);
+		return job;
+	}
+
+	id = atoi(name[0] == '%' ? name + 1 : name);
+	for(job = job_list; job != NULL; job = job->next)
+		if(job->id == id)
+			return job;
+	fprintf(stderr, "%s: No such job.\n", builtin);
+	return NULL;
+}
+
+/*
+ * This function resumes a stopped job in background (for "bg")
+ */
+void job_background(struct job *job){
+	job->background = 1;
+	job->notified = 0;
+	job_continue(job);
+	printf("[%d]  %s &\n", job->id, job->text);
+}
+
+/*
+ * This is the helper function for implementing "jobs" command
+ * "with_pids" (jobs -l) also prints the process group of every job and how long ago it was started
+ */
+void jobs_print(int with_pids){
+	struct job *job, *next, *current;
+	struct timespec now;
+
+	jobs_reap();
+	current = job_find_quiet();
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	for(job = job_list; job != NULL; job = next){
+		next = job->next;
+
+		// A pipeline still starting its commands (one running "jobs") is not listed
+		if(job->starting)
+			continue;
+		if(with_pids)
+			out_printf(&shell_out, "[%d]%c %d  %-8s %5lds  %s\n", job->id, job == current ? '+' : ' ', (int) job->pgid,
+				state_names[job->state], (long) (now.tv_sec - job->started.tv_sec), job->text);
+		else
+			out_printf(&shell_out, "[%d]%c  %-8s\t%s\n", job->id, job == current ? '+' : ' ', state_names[job->state], job->text);
+		if(job->state != JOB_RUNNING)
+			job->notified = 1;
+
+		// A finished job has been reported now
+		if(job->state == JOB_DONE)
+			job_remove(job);
+	}
+}
+
+/*
+ * This function returns the most recently started job without printing anything, or NULL if there are no jobs
+ */
+struct job *job_find_quiet(){
+	struct job *job, *last = NULL;
+
+	for(job = job_list; job != NULL; job = job->next)
+		if(!job->starting && (last == NULL || job->id > last->id))
+			last = job;
+	return last;
+}
+
+/*
+ * This function checks if any job finished, or stopped without the user being told yet
+ */
+int jobs_changed(){
+	struct job *job;
+
+	for(job = job_list; job != NULL; job = job->next)
+		if(job->state == JOB_DONE || (job->state == JOB_STOPPED && !job->notified))
+			return 1;
+	return 0;
+}
+
+/*
+ * This function reports the background jobs that finished or were stopped since the last prompt
+ * The jobs that are done are removed from the job table afterwards
+ * "verbose" is clear for a script, which prints nothing and keeps the finished jobs, so "wait %n" still gets their exit status
+ * (they are removed by "wait" or once "jobs" has shown them, and the oldest ones once there are more than DONE_JOBS_MAX)
+ */
+void jobs_notify(int verbose){
+	struct job *job, *next, *oldest;
+	int ndone = 0;
+
+	jobs_reap();
+
+	for(job = job_list; job != NULL; job = next){
+		next = job->next;
+
+		if(job->state == JOB_DONE){
+			if(!verbose){
+				ndone++;
+				continue;
+			}
+			if(!job->notified){
+				if(job->status == 0)
+					printf("[%d]   Done\t\t\t%s\n", job->id, job->text);
+				else
+					printf("[%d]   Exit %d\t\t\t%s\n", job->id, job->status, job->text);
+			}
+			job_remove(job);
+		}
+		else if(job->state == JOB_STOPPED && !job->notified){
+			if(verbose)
+				printf("[%d]+  Stopped\t\t%s\n", job->id, job->text);
+			job->notified = 1;
+		}
+	}
+
+	// The job numbers are reused, so the oldest finished job is the one that finished first
+	for( ; ndone > DONE_JOBS_MAX; ndone--){
+		oldest = NULL;
+		for(job = job_list; job != NULL; job = job->next)
+			if(job->state == JOB_DONE && (oldest == NULL || job->finished.tv_sec < oldest->finished.tv_sec ||
+			   (job->finished.tv_sec == oldest->finished.tv_sec && job->finished.tv_nsec < oldest->finished.tv_nsec)))
+				oldest = job;
+		job_remove(oldest);
+	}
+	fflush(stdout);
+}
+
+/*
+ * This is the helper function for implementing "wait" command
+ * It waits for the given job, or for EVERY background job if "job" is NULL
+ * Returns the exit status of the (last) job waited for
+ */
+int jobs_wait(struct job *job){
+	struct job *next;
+	int status = 0;
+
+	if(job != NULL){
+		status = job_wait(job);
+		if(job->state == JOB_DONE)
+			job_remove(job);
+		return status;
+	}
+
+	for(job = job_list; job != NULL; job = next){
+		next = job->next;
+		if(job->state == JOB_STOPPED)
+			continue;
+		status = job_wait(job);
+		if(job->state == JOB_DONE)
+			job_remove(job);
+	}
+	return status;
+}
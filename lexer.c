@@ -0,0 +1,221 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that splits a command line into tokens in ONE pass over the line
+ *   - Words may be quoted with '...' (taken literally) or "..." (where \" and \\ are escaped), or contain \ escaped characters
+ *   - Operators do not need any spaces around them, so "a>b" is the word "a", the operator ">" and the word "b"
+ *   - A number written right before "<" or ">" (e.g. "2>") selects the file descriptor being redirected
+ *   - A word with unquoted wildcards also gets a pattern for "wildcard.c", where the wildcards that WERE quoted are escaped
+ *     with "\", so ONLY the unquoted ones match anything ("a*"b* matches the names starting with a*b)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "sh.h"
+
+// Growable buffer used for the text of the word that is currently being scanned
+struct wordbuf {
+	char *text;
+	int   len;
+	int   cap;
+};
+
+static void wordbuf_add(struct wordbuf *w, char c){
+	if(w->len + 1 >= w->cap){
+		w->cap = w->cap ? 2 * w->cap : 32;
+		w->text = (char *) realloc(w->text, w->cap);
+	}
+	w->text[w->len++] = c;
+	w->text[w->len] = '\0';
+}
+
+// Adds a character of a word to its text and to its pattern, a quoted wildcard (or "\\") is escaped in the pattern
+static void word_add(struct wordbuf *w, struct wordbuf *pattern, char c, int quoted){
+	if(quoted && (c == '*' || c == '?' || c == '[' || c == '\\'))
+		wordbuf_add(pattern, '\\');
+	wordbuf_add(pattern, c);
+	wordbuf_add(w, c);
+}
+
+// Appends a token at the end of the growable token array
+static void add_token(struct token **tokens, int *ntokens, int *cap, int type, char *text, int fd, char *glob){
+	if(*ntokens + 1 >= *cap){
+		*cap = *cap ? 2 * (*cap) : 16;
+		*tokens = (struct token *) realloc(*tokens, sizeof(struct token) * (*cap));
+	}
+	(*tokens)[*ntokens].type = type;
+	(*tokens)[*ntokens].text = text;
+	(*tokens)[*ntokens].fd   = fd;
+	(*tokens)[*ntokens].glob = glob;
+	(*ntokens)++;
+}
+
+// Characters that end a word when they are not quoted
+static int is_operator_char(char c){
+	return c == '|' || c == '&' || c == ';' || c == '<' || c == '>';
+}
+
+/*
+ * This function splits "line" into tokens and returns them as an array terminated by a TOK_END token
+ * On a syntax error (unmatched quote), it prints the error message and returns NULL
+ * The returned array is released with free_tokens(...)
+ */
+struct token *lex_line(const char *line){
+	struct token *tokens = NULL;
+	int ntokens = 0, cap = 0;
+	const char *p = line;
+
+	while(*p){
+		// Spaces, tabs and the newline from fgets(...) only separate tokens
+		if(*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'){
+			p++;
+			continue;
+		}
+
+		// "#" at the beginning of a word starts a comment running to the end of the line
+		if(*p == '#')
+			break;
+
+		// A number that is immediately followed by "<" or ">" is the file descriptor of the redirection
+		int fd = -1;
+		if(isdigit((unsigned char) *p)){
+			const char *q = p;
+			while(isdigit((unsigned char) *q))
+				q++;
+			if(*q == '<' || *q == '>'){
+				fd = atoi(p);
+				p = q;
+			}
+		}
+
+		// Operators
+		if(*p == '|'){
+			if(p[1] == '&'){
+				add_token(&tokens, &ntokens, &cap, TOK_PIPE_ERR, NULL, -1, NULL);
+				p += 2;
+			}
+			else{
+				add_token(&tokens, &ntokens, &cap, TOK_PIPE, NULL, -1, NULL);
+				p++;
+			}
+			continue;
+		}
+		if(*p == '&'){
+			add_token(&tokens, &ntokens, &cap, TOK_BG, NULL, -1, NULL);
+			p++;
+			continue;
+		}
+		if(*p == ';'){
+			add_token(&tokens, &ntokens, &cap, TOK_SEMI, NULL, -1, NULL);
+			p++;
+			continue;
+		}
+		if(*p == '<'){
+			add_token(&tokens, &ntokens, &cap, TOK_REDIR_IN, NULL, fd, NULL);
+			p++;
+			continue;
+		}
+		if(*p == '>'){
+			// Longest operator first: ">>&", ">>", ">&", ">"
+			if(p[1] == '>' && p[2] == '&'){
+				add_token(&tokens, &ntokens, &cap, TOK_APPEND_ERR, NULL, fd, NULL);
+				p += 3;
+			}
+			else if(p[1] == '>'){
+				add_token(&tokens, &ntokens, &cap, TOK_APPEND, NULL, fd, NULL);
+				p += 2;
+			}
+			else if(p[1] == '&'){
+				add_token(&tokens, &ntokens, &cap, TOK_REDIR_OUT_ERR, NULL, fd, NULL);
+				p += 2;
+			}
+			else{
+				add_token(&tokens, &ntokens, &cap, TOK_REDIR_OUT, NULL, fd, NULL);
+				p++;
+			}
+			continue;
+		}
+
+		// Anything else is a word, which runs until an unquoted space or operator
+		struct wordbuf w = { NULL, 0, 0 }, pattern = { NULL, 0, 0 };
+		int glob = 0;
+		wordbuf_add(&w, '\0');
+		w.len = 0;
+		wordbuf_add(&pattern, '\0');
+		pattern.len = 0;
+		while(*p && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r' && !is_operator_char(*p)){
+			if(*p == '\''){
+				// Single quotes: everything up to the closing quote is taken literally
+				p++;
+				while(*p && *p != '\'')
+					word_add(&w, &pattern, *p++, 1);
+				if(*p != '\''){
+					fprintf(stderr, "Unmatched '.\n");
+					free(w.text);
+					free(pattern.text);
+					free_tokens(tokens, ntokens);
+					return NULL;
+				}
+				p++;
+			}
+			else if(*p == '"'){
+				// Double quotes: ONLY \" and \\ are escaped inside them
+				p++;
+				while(*p && *p != '"'){
+					if(*p == '\\' && (p[1] == '"' || p[1] == '\\'))
+						p++;
+					word_add(&w, &pattern, *p++, 1);
+				}
+				if(*p != '"'){
+					fprintf(stderr, "Unmatched \".\n");
+					free(w.text);
+					free(pattern.text);
+					free_tokens(tokens, ntokens);
+					return NULL;
+				}
+				p++;
+			}
+			else if(*p == '\\' && p[1]){
+				// Backslash: next character is taken literally
+				p++;
+				word_add(&w, &pattern, *p++, 1);
+			}
+			else{
+				// Unquoted wildcard characters make the word a pattern for glob expansion
+				if(*p == '*' || *p == '?' || *p == '[')
+					glob = 1;
+				word_add(&w, &pattern, *p++, 0);
+			}
+		}
+
+		// ONLY a word with unquoted wildcards keeps its pattern
+		if(!glob){
+			free(pattern.text);
+			pattern.text = NULL;
+		}
+		add_token(&tokens, &ntokens, &cap, TOK_WORD, w.text, -1, pattern.text);
+	}
+
+	add_token(&tokens, &ntokens, &cap, TOK_END, NULL, -1, NULL);
+	return tokens;
+}
+
+/*
+ * This function frees the tokens returned by lex_line(...)
+ * "ntokens" is the number of tokens to free, or -1 to free up to the TOK_END token
+ */
+void free_tokens(struct token *tokens, int ntokens){
+	int i;
+
+	if(tokens == NULL)
+		return;
+	for(i = 0; ntokens < 0 ? tokens[i].type != TOK_END : i < ntokens; i++){
+		free(tokens[i].text);
+		free(tokens[i].glob);
+	}
+	free(tokens);
+}
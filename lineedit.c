@@ -0,0 +1,477 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that implements the line editor of our interactive Shell
+ *   - While the shell waits at the prompt, the terminal is put in raw mode (no line buffering, no echo), so the shell
+ *     sees every key: the line is edited and echoed here and given to the shell when ENTER is pressed
+ *   - The keys are taken from the reader of "input.c" as the event loop of "event.c" reads them, so the editor never blocks
+ *   - CTRL-C and CTRL-Z still send signals (ISIG is kept), and the event loop calls edit_discard(...) for CTRL-C
+ *   - Keys:  LEFT/RIGHT, CTRL-B/CTRL-F move, HOME/END, CTRL-A/CTRL-E go to the start/end, BACKSPACE/DELETE, CTRL-D delete,
+ *            CTRL-U/CTRL-K delete before/after the cursor, CTRL-W deletes the word before it, CTRL-L clears the screen,
+ *            UP/DOWN, CTRL-P/CTRL-N go through the history, CTRL-R is the incremental search of the history,
+ *            TAB completes the word at the cursor (see "complete.c"), a second TAB lists what it can be completed to
+ *   - The line is edited on ONE row of the terminal, a line longer than the terminal is wider is not wrapped
+ */
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sh.h"
+
+#define CONTROL(c)  ((c) & 0x1f)
+#define LIST_ASK    100          // more candidates than this are listed ONLY if the user says so
+
+static struct termios cooked;    // modes of the terminal when the shell started, restored while commands run
+static int have_cooked = 0;
+static int raw = 0;              // set while the terminal is in raw mode
+
+static char  *line = NULL;       // line being edited
+static size_t len = 0, cap = 0, pos = 0;   // its length, allocated size and the cursor
+
+static char  *saved = NULL;      // what was typed before UP went into the history
+static long   hist_pos = 0;      // command line of the history shown, 0 for the line being typed
+
+static int    searching = 0;     // set in the incremental search (CTRL-R)
+static char   query[256];
+static size_t qlen = 0;
+static long   match = 0;         // command line of the history the search found, 0 if none
+
+static int    esc = 0;           // escape sequence: 1 after ESC, 2 after "ESC [" or "ESC O"
+static int    esc_param = 0;     // number inside "ESC [ n ~"
+
+static struct completion comp;   // candidates of the last TAB
+static int    last_key = 0;      // key being handled, and the one before it: a second TAB lists the candidates
+static int    prev_key = 0;
+static int    asking = 0;        // set while "Display all ... possibilities?" waits for an answer
+
+// Writes to the terminal directly, the prompt went through stdio so it is flushed first
+static void out(const char *s, size_t n){
+	ssize_t w;
+
+	fflush(stdout);
+	while(n > 0 && (w = write(STDOUT_FILENO, s, n)) > 0){
+		s += w;
+		n -= w;
+	}
+}
+
+static void outs(const char *s){
+	out(s, strlen(s));
+}
+
+// Replaces the line with the given text, the cursor goes to its end
+static void set_line(const char *text){
+	size_t n = strlen(text);
+
+	if(n + 1 > cap){
+		cap = n + 256;
+		line = (char *) realloc(line, cap);
+	}
+	memcpy(line, text, n + 1);
+	len = pos = n;
+}
+
+/*
+ * This function prints the prompt and the line again, with the cursor where it was
+ * In the incremental search it prints the query and the match instead
+ */
+void edit_redraw(){
+	char moves[32];
+	const char *found;
+
+	outs("\r\x1b[K");
+	if(searching){
+		found = match ? history_line(match) : "";
+		outs(match || qlen == 0 ? "(reverse-i-search)`" : "(failing reverse-i-search)`");
+		out(query, qlen);
+		outs("': ");
+		outs(found);
+		return;
+	}
+	print_prompt();
+	fflush(stdout);
+	out(line, len);
+	if(pos < len){
+		snprintf(moves, sizeof(moves), "\x1b[%zuD", len - pos);
+		outs(moves);
+	}
+}
+
+/*
+ * This function puts the terminal in raw mode and starts a new empty line
+ * Returns 0 if the terminal can't be put in raw mode, then the line is read without the editor
+ */
+int edit_begin(){
+	struct termios t;
+
+	// The modes of the terminal are taken ONCE: a command that changed them and was stopped doesn't change them for the shell
+	if(!have_cooked){
+		if(tcgetattr(STDIN_FILENO, &cooked) != 0)
+			return 0;
+		have_cooked = 1;
+	}
+	t = cooked;
+	t.c_lflag &= ~(ICANON | ECHO | IEXTEN);
+	t.c_cc[VMIN] = 1;
+	t.c_cc[VTIME] = 0;
+	if(tcsetattr(STDIN_FILENO, TCSADRAIN, &t) != 0)
+		return 0;
+	raw = 1;
+
+	set_line("");
+	hist_pos = 0;
+	searching = 0;
+	esc = 0;
+	return 1;
+}
+
+/*
+ * This function gives the terminal its modes back, before the command line runs
+ */
+void edit_end(){
+	if(raw)
+		tcsetattr(STDIN_FILENO, TCSADRAIN, &cooked);
+	raw = 0;
+}
+
+/*
+ * This function throws away the line being edited (CTRL-C at the prompt)
+ */
+void edit_discard(){
+	set_line("");
+	hist_pos = 0;
+	searching = 0;
+	esc = 0;
+}
+
+// Inserts the characters at the cursor
+static void insert(const char *s, size_t n){
+	if(len + n + 1 > cap){
+		cap = 2 * (len + n) + 256;
+		line = (char *) realloc(line, cap);
+	}
+	memmove(line + pos + n, line + pos, len - pos + 1);
+	memcpy(line + pos, s, n);
+	len += n;
+	pos += n;
+}
+
+// Deletes the characters from "from" up to (not including) "to"
+static void erase(size_t from, size_t to){
+	memmove(line + from, line + to, len - to + 1);
+	len -= to - from;
+	pos = from;
+}
+
+// Shows command line "seq" of the history, or with 0 the line that was being typed
+static void browse(long seq){
+	if(hist_pos == 0){
+		free(saved);
+		saved = strdup(line);
+	}
+	hist_pos = seq;
+	set_line(seq ? history_line(seq) : saved);
+}
+
+// Searches the query again, starting at command line "before" of the history (not included)
+static void search(long before){
+	long found = qlen ? history_search(query, before, 0) : 0;
+
+	// A query that is not found keeps the last match, as in other shells
+	if(found || qlen == 0)
+		match = found;
+	else if(match && strstr(history_line(match), query) == NULL)
+		match = 0;
+}
+
+// Ends the incremental search, keeping the command line it found
+static void search_accept(){
+	searching = 0;
+	if(match){
+		set_line(history_line(match));
+		hist_pos = 0;
+	}
+}
+
+/*
+ * Handles ONE key of the incremental search
+ * Returns 1 if the key was used, 0 if the search ended and the key has to be handled as a normal key
+ */
+static int search_key(int c){
+	if(c == CONTROL('R')){
+		// CTRL-R again looks for an older command line
+		search(match ? match : history_last() + 1);
+		return 1;
+	}
+	if(c == CONTROL('G')){
+		searching = 0;
+		set_line(saved ? saved : "");
+		return 1;
+	}
+	if(c == 0x7f || c == CONTROL('H')){
+		if(qlen > 0)
+			qlen--;
+		query[qlen] = '\0';
+		search(history_last() + 1);
+		return 1;
+	}
+	if((unsigned char) c >= 0x20 && c != 0x7f && qlen + 1 < sizeof(query)){
+		query[qlen++] = (char) c;
+		query[qlen] = '\0';
+		// The match stays if it still contains the longer query
+		search(match ? match + 1 : history_last() + 1);
+		return 1;
+	}
+	search_accept();
+	return 0;
+}
+
+// Inserts part of a name at the cursor, with a backslash before the characters the lexer would take as special
+static void insert_name(const char *name, size_t n){
+	size_t i;
+
+	for(i = 0; i < n; i++){
+		if(!comp.quote && strchr(" \t\\'\"|&;<>*?[#", name[i]) != NULL)
+			insert("\\", 1);
+		insert(name + i, 1);
+	}
+}
+
+// Prints the candidates in columns under the line, sorted down the columns as "ls" does
+static void list_candidates(){
+	struct winsize ws;
+	size_t width = 80, colwidth = 0, n, i;
+	int rows, cols, row, col, k;
+	char *buf;
+	size_t buflen = 0;
+
+	if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0)
+		width = ws.ws_col;
+	for(k = 0; k < comp.n; k++){
+		n = strlen(comp.v[k].name) + (comp.v[k].type == DT_DIR) + 2;
+		if(n > colwidth)
+			colwidth = n;
+	}
+	cols = colwidth < width ? (int) (width / colwidth) : 1;
+	rows = (comp.n + cols - 1) / cols;
+
+	buf = (char *) malloc((colwidth + 2) * (size_t) comp.n + (size_t) rows + 8);
+	buf[buflen++] = '\n';
+	for(row = 0; row < rows; row++){
+		for(col = 0; col < cols && (k = col * rows + row) < comp.n; col++){
+			n = strlen(comp.v[k].name);
+			memcpy(buf + buflen, comp.v[k].name, n);
+			buflen += n;
+			if(comp.v[k].type == DT_DIR)
+				buf[buflen++] = '/', n++;
+
+			// The last column is not padded
+			if(col + 1 < cols && (col + 1) * rows + row < comp.n)
+				for(i = n; i < colwidth; i++)
+					buf[buflen++] = ' ';
+		}
+		buf[buflen++] = '\n';
+	}
+	out(buf, buflen);
+	free(buf);
+}
+
+/*
+ * Completes the word at the cursor: inserts what ALL the candidates have in common after what was typed
+ * With ONE candidate, the word is finished with a space (or a "/" for a directory); a second TAB lists the candidates
+ */
+static void complete_key(){
+	size_t plen, common, i;
+	int k, second = (prev_key == '\t');
+
+	if(complete(line, pos, &comp) == 0){
+		outs("\a");
+		return;
+	}
+
+	plen = strlen(comp.prefix);
+	common = strlen(comp.v[0].name);
+	for(k = 1; k < comp.n; k++){
+		for(i = plen; i < common && comp.v[k].name[i] == comp.v[0].name[i]; i++);
+		common = i;
+	}
+
+	if(common > plen)
+		insert_name(comp.v[0].name + plen, common - plen);
+	if(comp.n == 1){
+		if(comp.v[0].type == DT_DIR)
+			insert("/", 1);
+		else{
+			if(comp.quote)
+				insert(&comp.quote, 1);
+			insert(" ", 1);
+		}
+		return;
+	}
+
+	if(common > plen)
+		return;
+	if(!second){
+		outs("\a");
+		return;
+	}
+	if(comp.n > LIST_ASK){
+		char question[64];
+		snprintf(question, sizeof(question), "\nDisplay all %d possibilities? (y or n)", comp.n);
+		outs(question);
+		asking = 1;
+		return;
+	}
+	list_candidates();
+}
+
+/*
+ * Handles the rest of an escape sequence (the arrows and HOME, END, DELETE)
+ */
+static void escape_key(int c){
+	if(esc == 1){
+		esc = (c == '[' || c == 'O') ? 2 : 0;
+		esc_param = 0;
+		return;
+	}
+	if(c >= '0' && c <= '9'){
+		esc_param = esc_param * 10 + (c - '0');
+		return;
+	}
+	if(c == ';')
+		return;
+	esc = 0;
+
+	switch(c){
+		case 'A': if(hist_pos != history_first() && history_last() > 0)
+				browse(hist_pos ? hist_pos - 1 : history_last());
+			  break;
+		case 'B': if(hist_pos)
+				browse(hist_pos < history_last() ? hist_pos + 1 : 0);
+			  break;
+		case 'C': if(pos < len) pos++; break;
+		case 'D': if(pos > 0) pos--; break;
+		case 'H': pos = 0; break;
+		case 'F': pos = len; break;
+		case '~':
+			if(esc_param == 1 || esc_param == 7)
+				pos = 0;
+			else if(esc_param == 4 || esc_param == 8)
+				pos = len;
+			else if(esc_param == 3 && pos < len)
+				erase(pos, pos + 1);
+			break;
+		default: break;
+	}
+}
+
+/*
+ * This function takes the keys the reader has read so far and edits the line with them
+ * Returns the line once ENTER is pressed (it belongs to the editor and stays valid until the next call),
+ * or NULL if more keys are needed; "eof" is set for CTRL-D on an empty line
+ */
+char *edit_process(struct reader *rd, int *eof){
+	int c, changed = 0;
+	size_t start;
+
+	*eof = 0;
+	while(rd->start < rd->end){
+		c = (unsigned char) rd->buf[rd->start++];
+		changed = 1;
+		prev_key = last_key;
+		last_key = c;
+
+		// The answer to "Display all ... possibilities?"
+		if(asking){
+			asking = 0;
+			if(c == 'y' || c == 'Y')
+				list_candidates();
+			else
+				outs("\n");
+			continue;
+		}
+		if(esc){
+			escape_key(c);
+			continue;
+		}
+		if(searching){
+			if(c == '\r' || c == '\n')
+				search_accept();
+			else if(search_key(c))
+				continue;
+		}
+
+		switch(c){
+			case '\r':
+			case '\n':
+				outs("\r\x1b[K");
+				print_prompt();
+				fflush(stdout);
+				out(line, len);
+				outs("\n");
+				return line;
+			case 0x1b:
+				esc = 1;
+				break;
+			case CONTROL('D'):
+				if(len == 0){
+					*eof = 1;
+					return NULL;
+				}
+				if(pos < len)
+					erase(pos, pos + 1);
+				break;
+			case 0x7f:
+			case CONTROL('H'):
+				if(pos > 0)
+					erase(pos - 1, pos);
+				break;
+			case CONTROL('A'): pos = 0; break;
+			case CONTROL('E'): pos = len; break;
+			case CONTROL('B'): if(pos > 0) pos--; break;
+			case CONTROL('F'): if(pos < len) pos++; break;
+			case CONTROL('K'): line[len = pos] = '\0'; break;
+			case CONTROL('U'): erase(0, pos); break;
+			case CONTROL('W'):
+				for(start = pos; start > 0 && line[start - 1] == ' '; start--);
+				for( ; start > 0 && line[start - 1] != ' '; start--);
+				erase(start, pos);
+				break;
+			case CONTROL('L'):
+				outs("\x1b[H\x1b[2J");
+				break;
+			case '\t':
+				complete_key();
+				break;
+			case CONTROL('P'): escape_key('A'); break;
+			case CONTROL('N'): escape_key('B'); break;
+			case CONTROL('R'):
+				// The search starts from the newest command line, what was typed comes back with CTRL-G
+				free(saved);
+				saved = strdup(line);
+				searching = 1;
+				qlen = 0;
+				query[0] = '\0';
+				match = 0;
+				break;
+			default:
+				// Other control keys are ignored, everything else (UTF-8 too) is inserted as it is
+				if(c >= 0x20){
+					char ch = (char) c;
+					insert(&ch, 1);
+				}
+				break;
+		}
+	}
+
+	if(changed)
+		edit_redraw();
+	return NULL;
+}
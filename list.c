@@ -4,28 +4,749 @@
  * Date: March 13th, 2021
  *
  * This is the simple program that prints all the files in the given directory
+ *   - The directory is read with getdents64(...) into a big buffer, so a huge directory takes a handful of system calls
+ *   - Everything is printed into the output buffer of the built-in commands ("shell_out", see "output.c")
+ *     that is written out with writev(...) when it is full, instead of one printf(...) per file
+ *   - Options of the "list" command:
+ *       -s   sorts the names (with several threads for a huge directory)
+ *       -l   long format: type, permissions, links, owner, group, size and time of last modification (statx(...))
+ *       -F   marks the type of each file ("/" directory, "@" symbolic link, "|" FIFO, "=" socket)
+ *            from the directory entry itself, without any extra system call
+ *       -0   ends each name with a NUL character instead of a newline (for "xargs -0")
+ *       -R   lists every directory below too, see below
+ *       -T   prints the number of files and directories and their total size after each listing (of the whole subtree with "-R")
+ *   - "list -R" walks the tree with a pool of threads:
+ *       each thread keeps its own deque of directories to read, takes work from the bottom of it and,
+ *       when it runs out, steals from the top of the deque of another thread
+ *       a directory is opened with openat(...) relative to its parent, which stays open until all its subdirectories are opened
+ *       each directory is listed into its own buffer, and the calling thread prints the buffers in the same order
+ *       as a single-threaded walk would, so the output does not depend on which thread read what
  */
-#include<stdio.h>
-#include<stdlib.h>
-#include<sys/types.h>
-#include<dirent.h>
+
+#define _GNU_SOURCE
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <pwd.h>
+#include <grp.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sh.h"
+
+#define DENTS_BUFSIZE  (1 << 20)   // getdents64(...) buffer, about 30000 entries per system call
+#define PARALLEL_MIN   65536       // directories with fewer entries than this are sorted and stat'ed by ONE thread
+#define MAX_THREADS    8
+#define WALK_THREADS   16          // "list -R" waits for the disk most of the time, so it may use more threads than CPUs
+
+// One file of the directory, when the names have to be kept (for "-s" and "-l")
+struct list_entry {
+	char         *name;
+	unsigned int  info;    // index into the statx(...) results, for "-l"
+	unsigned char type;    // "d_type" of the directory entry
+};
+
+// What "-l" prints about a file, ONLY the fields it needs out of "struct statx"
+struct list_info {
+	mode_t    mode;
+	nlink_t   nlink;
+	uid_t     uid;
+	gid_t     gid;
+	long long size;
+	time_t    mtime;
+	int       ok;          // statx(...) succeeded
+};
+
+// Marker of "-F" for the type of the directory entry, '\0' for a regular file
+static char type_marker(unsigned char type){
+	switch(type){
+		case DT_DIR:  return '/';
+		case DT_LNK:  return '@';
+		case DT_FIFO: return '|';
+		case DT_SOCK: return '=';
+		default:      return '\0';
+	}
+}
+
+// Adds one name, with its marker and its end ('\n' or NUL)
+static void out_name(struct outbuf *ob, const char *name, unsigned char type, struct list_opts *opts){
+	char marker;
+
+	out_str(ob, name);
+	if(opts->classify && (marker = type_marker(type)) != '\0')
+		out_add(ob, &marker, 1);
+	out_add(ob, opts->nul ? "\0" : "\n", 1);
+}
+
+static int entry_cmp(const void *a, const void *b){
+	return strcmp(((const struct list_entry *) a)->name, ((const struct list_entry *) b)->name);
+}
+
+// Part of the array to sort, for one thread
+struct sort_job {
+	struct list_entry *v;
+	struct list_entry *tmp;   // scratch space of the same size, for merging
+	size_t n;
+	int    threads;           // threads this part may use
+};
 
 /*
- * This function will list all the files in a given directory
- * This is a helper function for implementing "list" command functionality of our Shell
+ * Sorts the entries: with ONE thread it is qsort(...), otherwise each half is sorted by its own threads
+ * and the two sorted halves are merged
+ */
+static void *sort_part(void *arg){
+	struct sort_job *job = (struct sort_job *) arg;
+	struct sort_job left, right;
+	pthread_t tid;
+	size_t half, i, j, k;
+
+	if(job->threads < 2 || job->n < PARALLEL_MIN){
+		qsort(job->v, job->n, sizeof(struct list_entry), entry_cmp);
+		return NULL;
+	}
+
+	half = job->n / 2;
+	left.v = job->v;           left.tmp = job->tmp;           left.n = half;            left.threads = job->threads / 2;
+	right.v = job->v + half;   right.tmp = job->tmp + half;   right.n = job->n - half;  right.threads = job->threads - left.threads;
+
+	// The right half gets a new thread, the left half is sorted by this one
+	if(pthread_create(&tid, NULL, sort_part, &right) != 0){
+		sort_part(&right);
+		tid = 0;
+	}
+	sort_part(&left);
+	if(tid != 0)
+		pthread_join(tid, NULL);
+
+	for(i = 0, j = half, k = 0; i < half && j < job->n; )
+		job->tmp[k++] = strcmp(job->v[i].name, job->v[j].name) <= 0 ? job->v[i++] : job->v[j++];
+	while(i < half)
+		job->tmp[k++] = job->v[i++];
+	while(j < job->n)
+		job->tmp[k++] = job->v[j++];
+	memcpy(job->v, job->tmp, sizeof(struct list_entry) * job->n);
+	return NULL;
+}
+
+// Threads to use for "n" entries, ONE for a directory that is not huge or when "parallel" is not set
+static int thread_count(size_t n, int parallel){
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if(!parallel || n < PARALLEL_MIN || cpus < 2)
+		return 1;
+	return cpus > MAX_THREADS ? MAX_THREADS : (int) cpus;
+}
+
+// Part of the entries to statx(...), for one thread
+struct stat_job {
+	int dirfd;
+	struct list_entry *v;
+	struct list_info  *info;
+	size_t first, n, step;
+};
+
+/*
+ * Gets the metadata of every "step"-th entry, relative to the directory that is already open,
+ * asking statx(...) ONLY for the fields "-l" prints
  */
-void list(char *dir){
-	DIR *dirstream = opendir(dir);
-	struct dirent *dp;
+static void *stat_part(void *arg){
+	struct stat_job *job = (struct stat_job *) arg;
+	struct statx stx;
+	struct list_info *in;
+	size_t i;
+
+	for(i = job->first; i < job->n; i += job->step){
+		in = &job->info[job->v[i].info];
+		in->ok = statx(job->dirfd, job->v[i].name, AT_SYMLINK_NOFOLLOW | AT_STATX_DONT_SYNC,
+		               STATX_TYPE | STATX_MODE | STATX_NLINK | STATX_UID | STATX_GID | STATX_SIZE | STATX_MTIME, &stx) == 0;
+		if(in->ok){
+			in->mode  = stx.stx_mode;
+			in->nlink = stx.stx_nlink;
+			in->uid   = stx.stx_uid;
+			in->gid   = stx.stx_gid;
+			in->size  = (long long) stx.stx_size;
+			in->mtime = stx.stx_mtime.tv_sec;
+		}
+	}
+	return NULL;
+}
+
+// statx(...) of ALL the entries, spread over several threads for a huge directory
+static void stat_entries(int dirfd, struct list_entry *v, struct list_info *info, size_t n, int parallel){
+	struct stat_job jobs[MAX_THREADS];
+	pthread_t tids[MAX_THREADS];
+	int threads = thread_count(n, parallel), t;
+
+	for(t = 0; t < threads; t++){
+		jobs[t].dirfd = dirfd;
+		jobs[t].v = v;
+		jobs[t].info = info;
+		jobs[t].first = t;
+		jobs[t].n = n;
+		jobs[t].step = threads;
+		if(t == 0 || pthread_create(&tids[t], NULL, stat_part, &jobs[t]) != 0)
+			tids[t] = 0;
+	}
+	for(t = 0; t < threads; t++){
+		if(tids[t] == 0)
+			stat_part(&jobs[t]);
+		else
+			pthread_join(tids[t], NULL);
+	}
+}
+
+// "-rwxr-xr-x" for the mode
+static void mode_string(mode_t mode, char *s){
+	const char *rwx = "rwxrwxrwx";
+	int i;
+
+	s[0] = S_ISDIR(mode) ? 'd' : S_ISLNK(mode) ? 'l' : S_ISFIFO(mode) ? 'p' : S_ISSOCK(mode) ? 's' :
+	       S_ISCHR(mode) ? 'c' : S_ISBLK(mode) ? 'b' : '-';
+	for(i = 0; i < 9; i++)
+		s[i + 1] = (mode & (0400 >> i)) ? rwx[i] : '-';
+	s[10] = '\0';
+}
+
+// Names of the owner and the group, the last ones looked up (by each thread) are kept since most files of a directory share them
+static const char *owner_name(uid_t uid){
+	static __thread uid_t last = (uid_t) -1;
+	static __thread char name[64];
+	struct passwd pwbuf, *pw;
+	char buf[1024];
 
-	// Unable to open directory stream
-	if(!dirstream)
+	if(uid != last){
+		last = uid;
+		if(getpwuid_r(uid, &pwbuf, buf, sizeof(buf), &pw) == 0 && pw != NULL)
+			snprintf(name, sizeof(name), "%s", pw->pw_name);
+		else
+			snprintf(name, sizeof(name), "%u", (unsigned int) uid);
+	}
+	return name;
+}
+
+static const char *group_name(gid_t gid){
+	static __thread gid_t last = (gid_t) -1;
+	static __thread char name[64];
+	struct group grbuf, *gr;
+	char buf[1024];
+
+	if(gid != last){
+		last = gid;
+		if(getgrgid_r(gid, &grbuf, buf, sizeof(buf), &gr) == 0 && gr != NULL)
+			snprintf(name, sizeof(name), "%s", gr->gr_name);
+		else
+			snprintf(name, sizeof(name), "%u", (unsigned int) gid);
+	}
+	return name;
+}
+
+// One line of "-l"
+static void out_long(struct outbuf *ob, int dirfd, struct list_entry *e, struct list_info *in, struct list_opts *opts){
+	char line[512], mode[11], when[32], target[4096];
+	struct tm tm;
+	ssize_t n;
+
+	if(!in->ok){
+		out_str(ob, "?????????? ");
+		out_name(ob, e->name, e->type, opts);
+		return;
+	}
+
+	mode_string(in->mode, mode);
+	localtime_r(&in->mtime, &tm);
+	strftime(when, sizeof(when), "%b %e %H:%M", &tm);
+	snprintf(line, sizeof(line), "%s %3lu %-8s %-8s %10lld %s ", mode, (unsigned long) in->nlink,
+	         owner_name(in->uid), group_name(in->gid), in->size, when);
+	out_str(ob, line);
+
+	// A symbolic link also shows where it points to
+	if(S_ISLNK(in->mode) && !opts->nul && (n = readlinkat(dirfd, e->name, target, sizeof(target) - 1)) >= 0){
+		target[n] = '\0';
+		out_str(ob, e->name);
+		if(opts->classify)
+			out_add(ob, "@", 1);
+		out_str(ob, " -> ");
+		out_str(ob, target);
+		out_add(ob, "\n", 1);
 		return;
-	while((dp = readdir(dirstream)) != NULL){
-		// d_name is one of the fields of structure "dirent" which represents the name of file 
-		printf("%s\n", dp->d_name);
 	}
+	out_name(ob, e->name, e->type, opts);
+}
+
+// What "-T" counts
+struct list_totals {
+	long long files;   // everything that is not a directory
+	long long dirs;
+	long long bytes;   // sizes of the files that are not directories
+};
+
+// One directory of "list -R"
+struct walk_node {
+	char   *path;                 // as printed, "dir/sub/subsub"
+	char   *name;                 // last component, opened with openat(...) relative to the parent
+	struct walk_node *parent;
+	int     fd;
+	_Atomic int unopened;         // subdirectories that still need "fd" for their openat(...)
+	int     error;                // errno if the directory could not be opened
+	struct outbuf out;            // the listing of the directory
+	struct walk_node **children;  // subdirectories, in the order they are listed
+	int     nchildren;
+	int     cap;
+	struct list_totals totals;    // of this directory alone
+	int     done;                 // set once the directory is listed, guarded by the lock of the walker
+};
+
+static int is_dot(const char *name){
+	return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+// Checks if the entry is a directory, from "d_type" or the statx(...) result, and with fstatat(...) ONLY if neither tells
+static int entry_is_dir(int fd, const char *name, unsigned char type, struct list_info *in){
+	struct stat st;
+
+	if(type != DT_UNKNOWN)
+		return type == DT_DIR;
+	if(in != NULL && in->ok)
+		return S_ISDIR(in->mode);
+	return fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(st.st_mode);
+}
+
+// Adds a subdirectory to be walked to the node
+static void walk_add_child(struct walk_node *node, const char *name){
+	struct walk_node *child = (struct walk_node *) calloc(1, sizeof(struct walk_node));
+	size_t len = strlen(node->path);
+
+	child->name = strdup(name);
+	child->path = (char *) malloc(len + strlen(name) + 2);
+	strcpy(child->path, node->path);
+	if(len == 0 || node->path[len - 1] != '/')
+		strcat(child->path, "/");
+	strcat(child->path, name);
+	child->parent = node;
+	child->fd = -1;
+	child->out.fd = -1;
+
+	if(node->nchildren == node->cap){
+		node->cap = node->cap ? 2 * node->cap : 8;
+		node->children = (struct walk_node **) realloc(node->children, sizeof(struct walk_node *) * node->cap);
+	}
+	node->children[node->nchildren++] = child;
+}
+
+// Counts the entry for "-T"
+static void count_entry(struct list_totals *totals, int dir, struct list_info *in){
+	if(dir)
+		totals->dirs++;
+	else{
+		totals->files++;
+		if(in != NULL && in->ok)
+			totals->bytes += in->size;
+	}
+}
+
+/*
+ * This function will list all the files of the directory open as "fd" into "ob"
+ * This is a helper function for implementing "list" command functionality of our Shell
+ *   - Without "-s", "-l" and "-T", the names are printed straight out of the getdents64(...) buffer, so nothing is kept in memory
+ *   - "node" (for "list -R") gets every subdirectory as a child, in the order they are listed
+ *   - "totals" gets the numbers of "-T"
+ *   - "parallel" lets a huge directory be sorted and stat'ed by several threads
+ */
+static void list_fd(int fd, struct outbuf *ob, struct list_opts *opts, struct walk_node *node, struct list_totals *totals, int parallel){
+	struct list_entry *entries = NULL;
+	struct list_info *info = NULL, *in;
+	char *dents, *pool = NULL;
+	size_t nentries = 0, cap = 0, poolsize = 0, poolcap = 0, i;
+	int keep = opts->sort || opts->long_format || opts->totals, dir;
+	long pos, got;
+
+	dents = (char *) malloc(DENTS_BUFSIZE);
+
+	while((got = getdents64(fd, dents, DENTS_BUFSIZE)) > 0){
+		for(pos = 0; pos < got; ){
+			struct dirent64 *d = (struct dirent64 *) (dents + pos);
+			size_t len;
+
+			pos += d->d_reclen;
+			if(!keep){
+				out_name(ob, d->d_name, d->d_type, opts);
+				if(node != NULL && !is_dot(d->d_name) && entry_is_dir(fd, d->d_name, d->d_type, NULL))
+					walk_add_child(node, d->d_name);
+				continue;
+			}
+
+			// The names are kept in one pool, the entries point into it once the pool stops growing
+			len = strlen(d->d_name) + 1;
+			if(poolsize + len > poolcap){
+				poolcap = poolcap ? 2 * poolcap : DENTS_BUFSIZE;
+				while(poolsize + len > poolcap)
+					poolcap *= 2;
+				pool = (char *) realloc(pool, poolcap);
+			}
+			if(nentries == cap){
+				cap = cap ? 2 * cap : 1024;
+				entries = (struct list_entry *) realloc(entries, sizeof(struct list_entry) * cap);
+			}
+			memcpy(pool + poolsize, d->d_name, len);
+			entries[nentries].name = (char *) poolsize;   // an offset until the pool is complete
+			entries[nentries].info = nentries;
+			entries[nentries].type = d->d_type;
+			nentries++;
+			poolsize += len;
+		}
+	}
+	free(dents);
+
+	if(keep){
+		for(i = 0; i < nentries; i++)
+			entries[i].name = pool + (size_t) entries[i].name;
+
+		if(opts->long_format || opts->totals){
+			info = (struct list_info *) malloc(sizeof(struct list_info) * (nentries ? nentries : 1));
+			stat_entries(fd, entries, info, nentries, parallel);
+		}
+
+		if(opts->sort){
+			struct sort_job job;
+
+			job.v = entries;
+			job.tmp = (struct list_entry *) malloc(sizeof(struct list_entry) * (nentries ? nentries : 1));
+			job.n = nentries;
+			job.threads = thread_count(nentries, parallel);
+			sort_part(&job);
+			free(job.tmp);
+		}
+
+		for(i = 0; i < nentries; i++){
+			in = info ? &info[entries[i].info] : NULL;
+			if(opts->long_format)
+				out_long(ob, fd, &entries[i], in, opts);
+			else
+				out_name(ob, entries[i].name, entries[i].type, opts);
+
+			if(is_dot(entries[i].name))
+				continue;
+			dir = entry_is_dir(fd, entries[i].name, entries[i].type, in);
+			if(opts->totals)
+				count_entry(totals, dir, in);
+			if(node != NULL && dir)
+				walk_add_child(node, entries[i].name);
+		}
+	}
+
+	free(info);
+	free(entries);
+	free(pool);
+}
+
+// Prints the numbers of "-T"
+static void out_totals(struct outbuf *ob, const char *path, struct list_totals *totals){
+	char line[256];
+
+	snprintf(line, sizeof(line), "total of %s: %lld files, %lld directories, %lld bytes\n", path, totals->files, totals->dirs, totals->bytes);
+	out_str(ob, line);
+}
+
+// Deque of directories of ONE thread of the walker: the thread itself works at the bottom, other threads steal from the top
+struct walk_deque {
+	pthread_mutex_t lock;
+	struct walk_node **v;   // the directories are v[top...bottom-1]
+	int top;
+	int bottom;
+	int cap;
+};
+
+struct walker {
+	struct list_opts *opts;
+	struct walk_deque deques[WALK_THREADS];
+	int nthreads;
+	_Atomic long pending;           // directories pushed that are not listed yet
+	_Atomic unsigned long pushes;   // changed after every push, so an idle thread knows there may be new work
+	pthread_mutex_t lock;           // guards "done" of the directories and the waiting for work
+	pthread_cond_t work;            // signaled after a push and once every directory is listed
+	pthread_cond_t done;            // signaled after a directory is listed
+};
+
+struct walk_thread {
+	struct walker *w;
+	int id;
+};
+
+static void deque_push(struct walk_deque *dq, struct walk_node *node){
+	pthread_mutex_lock(&dq->lock);
+	if(dq->bottom == dq->cap){
+		// Space that was stolen from the top is used again before the deque grows
+		if(dq->top > 0){
+			memmove(dq->v, dq->v + dq->top, sizeof(struct walk_node *) * (dq->bottom - dq->top));
+			dq->bottom -= dq->top;
+			dq->top = 0;
+		}
+		else{
+			dq->cap = dq->cap ? 2 * dq->cap : 64;
+			dq->v = (struct walk_node **) realloc(dq->v, sizeof(struct walk_node *) * dq->cap);
+		}
+	}
+	dq->v[dq->bottom++] = node;
+	pthread_mutex_unlock(&dq->lock);
+}
+
+// Takes the directory pushed last by the thread itself (so it walks depth-first, like the output is printed)
+static struct walk_node *deque_pop(struct walk_deque *dq){
+	struct walk_node *node = NULL;
+
+	pthread_mutex_lock(&dq->lock);
+	if(dq->bottom > dq->top)
+		node = dq->v[--dq->bottom];
+	if(dq->bottom == dq->top)
+		dq->top = dq->bottom = 0;
+	pthread_mutex_unlock(&dq->lock);
+	return node;
+}
+
+// Takes the OLDEST directory of another thread, the one most likely to have a big subtree below it
+static struct walk_node *deque_steal(struct walk_deque *dq){
+	struct walk_node *node = NULL;
+
+	pthread_mutex_lock(&dq->lock);
+	if(dq->bottom > dq->top)
+		node = dq->v[dq->top++];
+	pthread_mutex_unlock(&dq->lock);
+	return node;
+}
+
+/*
+ * Lists ONE directory for the walker and pushes its subdirectories to the deque of the thread
+ * The subdirectories are opened relative to it with openat(...), the last one of them to be opened closes it
+ */
+static void walk_read(struct walker *w, struct walk_deque *dq, struct walk_node *node){
+	int i;
+
+	if(node->parent != NULL){
+		node->fd = openat(node->parent->fd, node->name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+		if(node->fd < 0)
+			node->error = errno;
+		if(atomic_fetch_sub(&node->parent->unopened, 1) == 1)
+			close(node->parent->fd);
+	}
+
+	if(node->fd >= 0){
+		list_fd(node->fd, &node->out, w->opts, node, &node->totals, 0);
+		atomic_store(&node->unopened, node->nchildren);
+		if(node->nchildren == 0)
+			close(node->fd);
+	}
+
+	if(node->nchildren > 0){
+		atomic_fetch_add(&w->pending, node->nchildren);
+
+		// Pushed in reverse, so the first subdirectory is the next one this thread takes
+		for(i = node->nchildren - 1; i >= 0; i--)
+			deque_push(dq, node->children[i]);
+
+		pthread_mutex_lock(&w->lock);
+		atomic_fetch_add(&w->pushes, 1);
+		pthread_cond_broadcast(&w->work);
+		pthread_mutex_unlock(&w->lock);
+	}
+
+	pthread_mutex_lock(&w->lock);
+	node->done = 1;
+	pthread_cond_broadcast(&w->done);
+	if(atomic_fetch_sub(&w->pending, 1) == 1)
+		pthread_cond_broadcast(&w->work);    // the whole tree is listed, the threads can stop
+	pthread_mutex_unlock(&w->lock);
+}
+
+// Thread of the walker: works on its own deque, steals when it is empty and waits when there is nothing to steal
+static void *walk_thread(void *arg){
+	struct walk_thread *t = (struct walk_thread *) arg;
+	struct walker *w = t->w;
+	struct walk_node *node;
+	unsigned long seen;
+	int k;
+
+	for(;;){
+		seen = atomic_load(&w->pushes);
+		node = deque_pop(&w->deques[t->id]);
+		for(k = 1; node == NULL && k < w->nthreads; k++)
+			node = deque_steal(&w->deques[(t->id + k) % w->nthreads]);
+
+		if(node != NULL){
+			walk_read(w, &w->deques[t->id], node);
+			continue;
+		}
+		if(atomic_load(&w->pending) == 0)
+			break;
+
+		pthread_mutex_lock(&w->lock);
+		while(atomic_load(&w->pushes) == seen && atomic_load(&w->pending) > 0)
+			pthread_cond_wait(&w->work, &w->lock);
+		pthread_mutex_unlock(&w->lock);
+	}
+	return NULL;
+}
+
+static void walk_free(struct walk_node *node){
+	free(node->path);
+	free(node->name);
+	free(node->out.buf);
+	free(node->children);
+	free(node);
+}
+
+/*
+ * Prints the directory and everything below it, in the order of a single-threaded depth-first walk
+ * Each directory is printed as soon as it and every directory before it are listed, and freed right after
+ * Returns 0 if every directory could be opened and 1 otherwise
+ */
+static int walk_print(struct walker *w, struct walk_node *node, struct list_totals *sum){
+	struct list_totals sub;
+	int i, status = 0;
+
+	pthread_mutex_lock(&w->lock);
+	while(!node->done)
+		pthread_cond_wait(&w->done, &w->lock);
+	pthread_mutex_unlock(&w->lock);
+
+	out_str(&shell_out, node->path);
+	out_str(&shell_out, ":\n");
+	if(node->error){
+		out_flush(&shell_out);
+		fprintf(stderr, "%s: %s.\n", node->path, strerror(node->error));
+		status = 1;
+	}
+	out_add(&shell_out, node->out.buf, node->out.len);
+	out_add(&shell_out, "\n", 1);
+
+	*sum = node->totals;
+	for(i = 0; i < node->nchildren; i++){
+		status |= walk_print(w, node->children[i], &sub);
+		sum->files += sub.files;
+		sum->dirs  += sub.dirs;
+		sum->bytes += sub.bytes;
+		walk_free(node->children[i]);
+	}
+
+	if(w->opts->totals)
+		out_totals(&shell_out, node->path, sum);
+	return status;
+}
+
+/*
+ * This function lists the directory and every directory below it ("list -R") with a pool of threads
+ * The calling thread prints the listings while the pool is still reading the rest of the tree
+ * Returns 0 if every directory could be opened and 1 otherwise
+ */
+static int list_recursive(char *dir, struct list_opts *opts){
+	struct walker w;
+	struct walk_thread threads[WALK_THREADS];
+	pthread_t tids[WALK_THREADS];
+	struct walk_node *root;
+	struct list_totals sum;
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	int i, started = 0, status;
+
+	root = (struct walk_node *) calloc(1, sizeof(struct walk_node));
+	root->path = strdup(dir);
+	root->name = strdup(dir);
+	root->out.fd = -1;
+	if((root->fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) < 0){
+		out_flush(&shell_out);
+		fprintf(stderr, "%s: %s.\n", dir, strerror(errno));
+		walk_free(root);
+		return 1;
+	}
+
+	w.opts = opts;
+	w.nthreads = cpus < 1 ? 2 : (cpus * 2 > WALK_THREADS ? WALK_THREADS : (int) cpus * 2);
+	atomic_init(&w.pending, 1);
+	atomic_init(&w.pushes, 0);
+	pthread_mutex_init(&w.lock, NULL);
+	pthread_cond_init(&w.work, NULL);
+	pthread_cond_init(&w.done, NULL);
+	for(i = 0; i < w.nthreads; i++){
+		pthread_mutex_init(&w.deques[i].lock, NULL);
+		w.deques[i].v = NULL;
+		w.deques[i].top = w.deques[i].bottom = w.deques[i].cap = 0;
+	}
+	deque_push(&w.deques[0], root);
+
+	for(i = 0; i < w.nthreads; i++){
+		threads[i].w = &w;
+		threads[i].id = i;
+		if(pthread_create(&tids[i], NULL, walk_thread, &threads[i]) != 0)
+			break;
+		started++;
+	}
+
+	// Without any thread, this one walks the whole tree before printing it
+	if(started == 0)
+		walk_thread(&threads[0]);
+
+	status = walk_print(&w, root, &sum);
+
+	for(i = 0; i < started; i++)
+		pthread_join(tids[i], NULL);
+	for(i = 0; i < w.nthreads; i++){
+		pthread_mutex_destroy(&w.deques[i].lock);
+		free(w.deques[i].v);
+	}
+	pthread_mutex_destroy(&w.lock);
+	pthread_cond_destroy(&w.work);
+	pthread_cond_destroy(&w.done);
+	walk_free(root);
+	return status;
+}
+
+/*
+ * This function lists ONE directory
+ * "header" prints "directory:" before the listing and a blank line after it
+ * Returns 0 on success and 1 if the directory could not be read
+ */
+static int list(char *dir, struct list_opts *opts, int header){
+	struct list_totals totals = { 0, 0, 0 };
+	int fd;
+
+	if(opts->recursive)
+		return list_recursive(dir, opts);
+
+	if(header){
+		out_str(&shell_out, dir);
+		out_str(&shell_out, ":\n");
+	}
+	if((fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) < 0){
+		out_flush(&shell_out);
+		fprintf(stderr, "%s: %s.\n", dir, strerror(errno));
+	}
+	else{
+		list_fd(fd, &shell_out, opts, NULL, &totals, 1);
+		close(fd);
+		if(opts->totals)
+			out_totals(&shell_out, dir, &totals);
+	}
+	if(header)
+		out_add(&shell_out, "\n", 1);
+	return fd < 0;
+}
+
+/*
+ * This function lists every given directory, each one after a "directory:" line, or the current directory if none is given
+ * Returns 0 if every directory could be read and 1 otherwise
+ */
+int list_dirs(char **dirs, int ndirs, struct list_opts *opts){
+	int i, status = 0;
+
+	if(ndirs == 0)
+		status = list(".", opts, 0);
 
-	// Close the directory stream
-	closedir(dirstream);
+	for(i = 0; i < ndirs; i++)
+		status |= list(dirs[i], opts, 1);
+	out_flush(&shell_out);
+	return status;
 }
@@ -0,0 +1,154 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that implements the output buffer of the built-in commands
+ *   - Built-in commands print into "shell_out" with out_add(...), out_str(...) and out_printf(...) instead of printf(...),
+ *     so a built-in command that prints thousands of lines makes a handful of system calls
+ *   - The buffer is written out with writev(...): when something does not fit anymore, what is buffered and
+ *     the new bytes go out together in ONE system call, without copying the new bytes into the buffer first
+ *   - "shell_out" is empty whenever the file descriptors of the shell change: out_sync(...) is called by
+ *     redirect_builtin(...) and restore_builtin(...) before they swap STDOUT, and at the end of every built-in command
+ *   - Anything printed with printf(...) in between is kept in order: stdio is flushed before the buffer gets more bytes,
+ *     and the buffer is written out before stdio
+ *   - Every buffer counts the bytes and the system calls it took, for the "outstat" command
+ */
+
+#define _GNU_SOURCE
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdio_ext.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sh.h"
+
+#define OUT_BUFSIZE 65536
+
+static char stdout_buf[OUT_BUFSIZE];
+struct outbuf shell_out = { stdout_buf, 0, OUT_BUFSIZE, STDOUT_FILENO, 0, 0 };
+
+// Writes out what is buffered followed by "len" more bytes, in as few writev(...) calls as possible
+// If the reader went away (a closed pipe), the rest is thrown away
+static void write_out(struct outbuf *ob, const char *s, size_t len){
+	struct iovec iov[2];
+	int first = 0, count = 0;
+	ssize_t n;
+
+	if(ob->len > 0){
+		iov[count].iov_base = ob->buf;
+		iov[count++].iov_len = ob->len;
+	}
+	if(len > 0){
+		iov[count].iov_base = (void *) s;
+		iov[count++].iov_len = len;
+	}
+	ob->len = 0;
+
+	while(first < count){
+		n = writev(ob->fd, iov + first, count - first);
+		if(n < 0 && errno == EINTR)
+			continue;
+		if(n <= 0)
+			return;
+		ob->writes++;
+		ob->bytes += n;
+
+		// A short write continues where it stopped
+		while(first < count && (size_t) n >= iov[first].iov_len)
+			n -= iov[first++].iov_len;
+		if(first < count){
+			iov[first].iov_base = (char *) iov[first].iov_base + n;
+			iov[first].iov_len -= n;
+		}
+	}
+}
+
+// Something printed with printf(...) since the last call comes before what is added now
+static void order_stdio(struct outbuf *ob){
+	if(ob == &shell_out && __fpending(stdout) > 0){
+		write_out(ob, NULL, 0);
+		fflush(stdout);
+	}
+}
+
+/*
+ * This function adds "len" bytes to the buffer
+ * A buffer with "fd" -1 grows instead (e.g. the listing of one directory for "list -R")
+ */
+void out_add(struct outbuf *ob, const char *s, size_t len){
+	order_stdio(ob);
+	if(ob->len + len > ob->cap){
+		if(ob->fd < 0){
+			ob->cap = ob->cap ? ob->cap : 4096;
+			while(ob->len + len > ob->cap)
+				ob->cap *= 2;
+			ob->buf = (char *) realloc(ob->buf, ob->cap);
+		}
+		else{
+			// The buffer and the new bytes go out together, the new bytes are never copied
+			write_out(ob, s, len);
+			return;
+		}
+	}
+	memcpy(ob->buf + ob->len, s, len);
+	ob->len += len;
+}
+
+void out_str(struct outbuf *ob, const char *s){
+	out_add(ob, s, strlen(s));
+}
+
+/*
+ * This function adds formatted text to the buffer, like printf(...)
+ * The text is formatted right into the buffer when it fits there
+ */
+void out_printf(struct outbuf *ob, const char *fmt, ...){
+	char small[512], *s = small;
+	va_list ap;
+	int n;
+
+	order_stdio(ob);
+	va_start(ap, fmt);
+	n = vsnprintf(ob->buf + ob->len, ob->cap - ob->len, fmt, ap);
+	va_end(ap);
+	if(n < 0)
+		return;
+	if((size_t) n < ob->cap - ob->len){
+		ob->len += n;
+		return;
+	}
+
+	// It didn't fit, so it is formatted again on the side
+	if((size_t) n >= sizeof(small))
+		s = (char *) malloc(n + 1);
+	va_start(ap, fmt);
+	vsnprintf(s, n + 1, fmt, ap);
+	va_end(ap);
+	out_add(ob, s, n);
+	if(s != small)
+		free(s);
+}
+
+/*
+ * This function writes out everything in the buffer
+ */
+void out_flush(struct outbuf *ob){
+	if(ob->fd >= 0 && ob->len > 0)
+		write_out(ob, NULL, 0);
+	ob->len = 0;
+}
+
+/*
+ * This function writes out everything printed so far, by the built-in commands and with printf(...), in the order it was printed
+ * It must be called before STDOUT of the shell changes
+ */
+void out_sync(){
+	out_flush(&shell_out);
+	fflush(stdout);
+	fflush(stderr);
+}
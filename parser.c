@@ -0,0 +1,242 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that builds the command tree (AST) of a command line from the tokens of lex_line(...)
+ *   - A command line is a list of pipelines separated by ";" or "&" (the pipeline before "&" runs in background)
+ *   - A pipeline is a list of simple commands separated by "|" or "|&", "time" or "time -m" before it times the whole pipeline
+ *   - A simple command is a list of words together with an ordered list of its redirections
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "sh.h"
+
+// Appends a word at the end of the NULL terminated argument list of a simple command
+static void command_add_word(struct command *cmd, char *word, char *glob){
+	if(cmd->argc + 1 >= cmd->cap){
+		cmd->cap  = cmd->cap ? 2 * cmd->cap : 8;
+		cmd->argv = (char **) realloc(cmd->argv, sizeof(char *) * cmd->cap);
+		cmd->glob = (char **) realloc(cmd->glob, sizeof(char *) * cmd->cap);
+	}
+	cmd->argv[cmd->argc] = word;
+	cmd->glob[cmd->argc] = glob;
+	cmd->argc++;
+	cmd->argv[cmd->argc] = NULL;
+}
+
+// Checks if the given word is made ONLY of digits (target of "N>&M")
+static int is_number(const char *word){
+	if(*word == '\0')
+		return 0;
+	for( ; *word; word++)
+		if(!isdigit((unsigned char) *word))
+			return 0;
+	return 1;
+}
+
+/*
+ * Parses the redirection operator at tokens[*pos] together with the word after it and appends it to the command
+ * Returns 0 on success and -1 if the name of the file is missing
+ */
+static int parse_redirection(struct command *cmd, struct token *tokens, int *pos){
+	struct token *op = &tokens[*pos];
+	struct token *target = &tokens[*pos + 1];
+	struct redirection *r, **tail;
+
+	if(target->type != TOK_WORD){
+		fprintf(stderr, "Missing name for redirect.\n");
+		return -1;
+	}
+
+	r = (struct redirection *) calloc(1, sizeof(struct redirection));
+	r->dupfd = -1;
+	switch(op->type){
+		case TOK_REDIR_IN:      r->kind = REDIR_IN;     r->fd = 0; break;
+		case TOK_REDIR_OUT:     r->kind = REDIR_OUT;    r->fd = 1; break;
+		case TOK_APPEND:        r->kind = REDIR_APPEND; r->fd = 1; break;
+		case TOK_REDIR_OUT_ERR: r->kind = REDIR_OUT;    r->fd = 1; r->also_stderr = 1; break;
+		case TOK_APPEND_ERR:    r->kind = REDIR_APPEND; r->fd = 1; r->also_stderr = 1; break;
+	}
+
+	// An explicit file descriptor replaces the default one
+	// "N>&M" duplicates file descriptor M onto N instead of opening a file
+	if(op->fd != -1){
+		r->fd = op->fd;
+		r->also_stderr = 0;
+		if(op->type == TOK_REDIR_OUT_ERR && is_number(target->text)){
+			r->kind  = REDIR_DUP;
+			r->dupfd = atoi(target->text);
+		}
+	}
+
+	// The file name is moved from the token into the redirection
+	r->file = target->text;
+	target->text = NULL;
+
+	// Keep the redirections in the order they were written
+	for(tail = &cmd->redirs; *tail; tail = &((*tail)->next));
+	*tail = r;
+
+	*pos += 2;
+	return 0;
+}
+
+/*
+ * This function parses "line" and returns the list of pipelines that it contains
+ * Returns NULL if the line is empty or has a syntax error (the error message is already printed in that case)
+ * The returned list is released with free_pipelines(...)
+ */
+struct pipeline *parse_line(const char *line){
+	struct token *tokens;
+	struct pipeline *head = NULL, **pl_tail = &head, *pl = NULL;
+	struct command **cmd_tail = NULL, *cmd = NULL;
+	int pos = 0;
+
+	tokens = lex_line(line);
+	if(tokens == NULL)
+		return NULL;
+
+	while(tokens[pos].type != TOK_END){
+		// Start a new pipeline if needed
+		if(pl == NULL){
+			pl = (struct pipeline *) calloc(1, sizeof(struct pipeline));
+			cmd_tail = &pl->commands;
+		}
+
+		// Start a new simple command if needed
+		if(cmd == NULL){
+			cmd = (struct command *) calloc(1, sizeof(struct command));
+			*cmd_tail = cmd;
+			cmd_tail = &cmd->next;
+			pl->ncommands++;
+		}
+
+		switch(tokens[pos].type){
+			case TOK_WORD:
+				// "time" (and then "-m") before the first command is a prefix of the pipeline, not a word of the command
+				if(pl->ncommands == 1 && cmd->argc == 0 && cmd->redirs == NULL){
+					if(!pl->timed && strcmp(tokens[pos].text, "time") == 0){
+						pl->timed = TIME_HUMAN;
+						pos++;
+						break;
+					}
+					if(pl->timed == TIME_HUMAN && strcmp(tokens[pos].text, "-m") == 0){
+						pl->timed = TIME_MACHINE;
+						pos++;
+						break;
+					}
+				}
+
+				// The text and the pattern are moved from the token into the command
+				command_add_word(cmd, tokens[pos].text, tokens[pos].glob);
+				tokens[pos].text = NULL;
+				tokens[pos].glob = NULL;
+				pos++;
+				break;
+
+			case TOK_REDIR_IN:
+			case TOK_REDIR_OUT:
+			case TOK_REDIR_OUT_ERR:
+			case TOK_APPEND:
+			case TOK_APPEND_ERR:
+				if(parse_redirection(cmd, tokens, &pos) == -1)
+					goto syntax_error;
+				break;
+
+			case TOK_PIPE:
+			case TOK_PIPE_ERR:
+				// Both sides of a pipe must have a command
+				if(cmd->argc == 0 || tokens[pos + 1].type == TOK_END){
+					fprintf(stderr, "Invalid null command.\n");
+					goto syntax_error;
+				}
+				cmd->stderr_to_pipe = (tokens[pos].type == TOK_PIPE_ERR);
+				cmd = NULL;
+				pos++;
+				break;
+
+			case TOK_BG:
+			case TOK_SEMI:
+				if(cmd->argc == 0){
+					// ";" alone (or ";;") is just an empty command, "&" alone is an error
+					if(tokens[pos].type == TOK_BG || pl->ncommands > 1 || cmd->redirs || pl->timed){
+						fprintf(stderr, "Invalid null command.\n");
+						goto syntax_error;
+					}
+					free_pipelines(pl);
+					pl = NULL;
+					cmd = NULL;
+					pos++;
+					break;
+				}
+				pl->background = (tokens[pos].type == TOK_BG);
+				*pl_tail = pl;
+				pl_tail = &pl->next;
+				pl = NULL;
+				cmd = NULL;
+				pos++;
+				break;
+		}
+	}
+
+	// Last pipeline of the line
+	if(pl != NULL){
+		if(cmd == NULL || cmd->argc == 0){
+			fprintf(stderr, "Invalid null command.\n");
+			goto syntax_error;
+		}
+		*pl_tail = pl;
+	}
+
+	free_tokens(tokens, -1);
+	return head;
+
+syntax_error:
+	free_tokens(tokens, -1);
+	free_pipelines(pl);
+	free_pipelines(head);
+	return NULL;
+}
+
+/*
+ * This function frees all the redirections of a simple command
+ */
+static void free_redirections(struct redirection *r){
+	struct redirection *tmp;
+	while(r){
+		tmp = r->next;
+		free(r->file);
+		free(r);
+		r = tmp;
+	}
+}
+
+/*
+ * This function frees the list of pipelines returned by parse_line(...)
+ */
+void free_pipelines(struct pipeline *pl){
+	struct pipeline *next_pl;
+	struct command *cmd, *next_cmd;
+	int i;
+
+	while(pl){
+		next_pl = pl->next;
+		for(cmd = pl->commands; cmd; cmd = next_cmd){
+			next_cmd = cmd->next;
+			for(i = 0; i < cmd->argc; i++){
+				free(cmd->argv[i]);
+				free(cmd->glob[i]);
+			}
+			free(cmd->argv);
+			free(cmd->glob);
+			free_redirections(cmd->redirs);
+			free(cmd);
+		}
+		free(pl);
+		pl = next_pl;
+	}
+}
@@ -0,0 +1,552 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that keeps an index of EVERY executable in EVERY directory of PATH, on disk
+ *   - Each directory of PATH is read ONCE with getdents64(...), and the names of its files are stored sorted, together with
+ *     the time of last modification of the directory, so a directory that changed is noticed with ONE stat(...)
+ *   - Whether a file is executable is NOT stored: "chmod +x" doesn't change the directory, so a stored answer would go stale
+ *     (and stay stale in the file for every other shell). A name found in the index is checked with ONE faccessat(...) instead
+ *   - The index is a file in "$XDG_CACHE_HOME/mysh" (or "$HOME/.cache/mysh"), one per PATH, mapped with mmap(...) when
+ *     it is first needed: a new shell with the same PATH finds every command without reading any directory at all
+ *   - The file is NEVER changed in place: a new index is written to a temporary file and renamed over the old one,
+ *     so any number of shells can share it read-only
+ *   - A mapped file is checked from end to end before it is used (every count and offset has to lie inside the file),
+ *     a broken or truncated one is thrown away and built again
+ *   - The directories are checked again at most once a second (lazily, on the next lookup), and ONLY the directories
+ *     that changed are read again
+ *   - "which", "where" and finding external commands ask the index instead of calling access(...) for every directory
+ *     A relative directory in PATH (like ".") is not indexed, it is still checked with access(...)
+ *   - Every change of the index gets a new generation number, so whoever built something from it (the command table,
+ *     the completion) knows when to build it again
+ */
+
+#define _GNU_SOURCE
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <errno.h>
+#include <stdint.h>
+#include <time.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sh.h"
+
+#define PIDX_MAGIC       "MYSHPIX1"
+#define PIDX_VERSION     2              // 2: the names of every file, not only the executables
+#define REVALIDATE_NS    1000000000LL   // directories are checked again at most once a second
+#define DENTS_BUFSIZE    65536
+
+/*
+ * Layout of the index file:
+ *   struct pidx_header
+ *   struct pidx_dir   dirs[ndirs]     one per directory of PATH, in PATH order
+ *   uint32_t          names[nnames]   offsets of the names, the names of each directory are sorted
+ *   char              strings[]       the paths of the directories and the names, NUL terminated
+ */
+struct pidx_header {
+	char     magic[8];
+	uint32_t version;
+	uint32_t ndirs;
+	uint32_t nnames;
+	uint32_t reserved;
+	uint64_t size;        // size of the whole file
+};
+
+struct pidx_dir {
+	uint64_t path;        // offset of the path of the directory
+	int64_t  mtime_sec;   // time of last modification of the directory when it was read
+	int64_t  mtime_nsec;
+	uint64_t dev;
+	uint64_t ino;         // 0 if the directory does not exist
+	uint32_t first;       // index of its first name in "names"
+	uint32_t nnames;
+	uint32_t indexed;     // 0 for a relative directory, which is not indexed
+	uint32_t reserved;
+};
+
+static char   *map = NULL;            // the index, mapped from the file or (without a file) allocated
+static size_t  map_size = 0;
+static int     map_is_file = 0;
+static char   *index_file = NULL;     // path of the index file, NULL if there is no place for it
+static long long last_check_ns = 0;
+static unsigned int generation = 0;   // changes whenever the index is thrown away
+
+#define HDR     ((struct pidx_header *) map)
+#define DIRS    ((struct pidx_dir *) (map + sizeof(struct pidx_header)))
+#define NAMES   ((uint32_t *) (map + sizeof(struct pidx_header) + sizeof(struct pidx_dir) * HDR->ndirs))
+
+static long long now_ns(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Growable buffer for building a new index
+struct buffer {
+	char  *data;
+	size_t len;
+	size_t cap;
+};
+
+static size_t buffer_add(struct buffer *b, const void *data, size_t len){
+	size_t at = b->len;
+
+	if(b->len + len > b->cap){
+		b->cap = b->cap ? b->cap : 4096;
+		while(b->len + len > b->cap)
+			b->cap *= 2;
+		b->data = (char *) realloc(b->data, b->cap);
+	}
+	memcpy(b->data + at, data, len);
+	b->len += len;
+	return at;
+}
+
+static int name_cmp(const void *a, const void *b){
+	return strcmp(*(char * const *) a, *(char * const *) b);
+}
+
+/*
+ * Reads the names of the files of ONE directory into "names" (sorted), each name allocated
+ * Directories (and links to directories) are left out, whether a file is executable is checked when it is looked up
+ * Returns the number of names
+ */
+static int scan_dir(const char *dir, char ***names){
+	char *dents = (char *) malloc(DENTS_BUFSIZE);
+	struct stat st;
+	long pos, got;
+	int fd, n = 0, cap = 0;
+
+	*names = NULL;
+	if((fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) < 0){
+		free(dents);
+		return 0;
+	}
+
+	while((got = getdents64(fd, dents, DENTS_BUFSIZE)) > 0){
+		for(pos = 0; pos < got; ){
+			struct dirent64 *d = (struct dirent64 *) (dents + pos);
+			pos += d->d_reclen;
+
+			if(d->d_name[0] == '.' && (d->d_name[1] == '\0' || (d->d_name[1] == '.' && d->d_name[2] == '\0')))
+				continue;
+			if(d->d_type != DT_REG && d->d_type != DT_LNK && d->d_type != DT_UNKNOWN)
+				continue;
+
+			// A link must lead to a regular file
+			if(d->d_type != DT_REG && (fstatat(fd, d->d_name, &st, 0) != 0 || !S_ISREG(st.st_mode)))
+				continue;
+
+			if(n == cap){
+				cap = cap ? 2 * cap : 256;
+				*names = (char **) realloc(*names, sizeof(char *) * cap);
+			}
+			(*names)[n++] = strdup(d->d_name);
+		}
+	}
+	close(fd);
+	free(dents);
+
+	qsort(*names, n, sizeof(char *), name_cmp);
+	return n;
+}
+
+// Finds the directory in the current index, so that an unchanged directory is copied instead of read again
+static struct pidx_dir *old_dir(const char *dir, struct stat *st){
+	uint32_t i;
+
+	if(map == NULL)
+		return NULL;
+	for(i = 0; i < HDR->ndirs; i++){
+		struct pidx_dir *d = &DIRS[i];
+		if(d->indexed && strcmp(map + d->path, dir) == 0 && d->ino == (uint64_t) st->st_ino && d->dev == (uint64_t) st->st_dev &&
+		   d->mtime_sec == (int64_t) st->st_mtim.tv_sec && d->mtime_nsec == (int64_t) st->st_mtim.tv_nsec)
+			return d;
+	}
+	return NULL;
+}
+
+/*
+ * This function builds a new index of the given PATH and returns it (allocated), with its size in "size"
+ * Directories that didn't change since the current index was built are copied from it, unless "rescan" is set
+ */
+static char *build_index(struct pathlist *p, size_t *size, int rescan){
+	struct buffer strings = { NULL, 0, 0 }, names = { NULL, 0, 0 };
+	struct pidx_dir *dirs = (struct pidx_dir *) calloc(p->count ? p->count : 1, sizeof(struct pidx_dir));
+	struct pidx_header hdr;
+	struct pidx_dir *old;
+	struct stat st;
+	char **found, *index;
+	uint32_t off, k, nnames = 0;
+	size_t head, at;
+	int i, n;
+
+	for(i = 0; i < p->count; i++){
+		dirs[i].path = buffer_add(&strings, p->dirs[i], strlen(p->dirs[i]) + 1);
+		dirs[i].first = nnames;
+		if(p->dirs[i][0] != '/')
+			continue;
+		dirs[i].indexed = 1;
+
+		// The time of last modification is taken BEFORE reading, so a change made while reading is noticed next time
+		if(stat(p->dirs[i], &st) != 0)
+			continue;
+		dirs[i].dev = st.st_dev;
+		dirs[i].ino = st.st_ino;
+		dirs[i].mtime_sec = st.st_mtim.tv_sec;
+		dirs[i].mtime_nsec = st.st_mtim.tv_nsec;
+
+		if(!rescan && (old = old_dir(p->dirs[i], &st)) != NULL){
+			for(k = 0; k < old->nnames; k++){
+				char *name = map + NAMES[old->first + k];
+				off = buffer_add(&strings, name, strlen(name) + 1);
+				buffer_add(&names, &off, sizeof(off));
+			}
+			dirs[i].nnames = old->nnames;
+		}
+		else{
+			n = scan_dir(p->dirs[i], &found);
+			for(k = 0; k < (uint32_t) n; k++){
+				off = buffer_add(&strings, found[k], strlen(found[k]) + 1);
+				buffer_add(&names, &off, sizeof(off));
+				free(found[k]);
+			}
+			free(found);
+			dirs[i].nnames = n;
+		}
+		nnames += dirs[i].nnames;
+	}
+
+	// The offsets of the strings so far are relative to the string area, which comes last
+	head = sizeof(struct pidx_header) + sizeof(struct pidx_dir) * p->count + sizeof(uint32_t) * nnames;
+	for(i = 0; i < p->count; i++)
+		dirs[i].path += head;
+	for(k = 0; k < nnames; k++)
+		((uint32_t *) names.data)[k] += head;
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, PIDX_MAGIC, sizeof(hdr.magic));
+	hdr.version = PIDX_VERSION;
+	hdr.ndirs = p->count;
+	hdr.nnames = nnames;
+	hdr.size = head + strings.len;
+
+	*size = hdr.size;
+	index = (char *) malloc(hdr.size);
+	memcpy(index, &hdr, sizeof(hdr));
+	at = sizeof(hdr);
+	memcpy(index + at, dirs, sizeof(struct pidx_dir) * p->count);
+	at += sizeof(struct pidx_dir) * p->count;
+	if(nnames)
+		memcpy(index + at, names.data, sizeof(uint32_t) * nnames);
+	at += sizeof(uint32_t) * nnames;
+	if(strings.len)
+		memcpy(index + at, strings.data, strings.len);
+
+	free(dirs);
+	free(names.data);
+	free(strings.data);
+	return index;
+}
+
+// Name of the index file of the given PATH, or NULL if there is no HOME to keep it in
+static char *index_file_name(struct pathlist *p){
+	char *base = env_get("XDG_CACHE_HOME"), *name;
+	unsigned int h = 2166136261u;
+	const char *c;
+	int i;
+
+	// One index per PATH, so shells with different PATHs don't keep replacing each other's index
+	for(i = 0; i < p->count; i++){
+		for(c = p->dirs[i]; *c; c++){
+			h ^= (unsigned char) *c;
+			h *= 16777619u;
+		}
+		h ^= ':';
+		h *= 16777619u;
+	}
+
+	name = (char *) malloc(PATH_MAX);
+	if(base != NULL && base[0] == '/')
+		snprintf(name, PATH_MAX, "%s/mysh", base);
+	else if((base = env_get("HOME")) != NULL && base[0] == '/'){
+		snprintf(name, PATH_MAX, "%s/.cache", base);
+		mkdir(name, 0700);
+		strncat(name, "/mysh", PATH_MAX - strlen(name) - 1);
+	}
+	else{
+		free(name);
+		return NULL;
+	}
+	mkdir(name, 0700);
+	snprintf(name + strlen(name), PATH_MAX - strlen(name), "/pathindex-%08x", h);
+	return name;
+}
+
+static void unmap_index(){
+	if(map == NULL)
+		return;
+	generation++;
+	if(map_is_file)
+		munmap(map, map_size);
+	else
+		free(map);
+	map = NULL;
+	map_size = 0;
+	map_is_file = 0;
+}
+
+// Checks that every count and offset of the mapped index lies inside it, so a broken file can't make a lookup read past the end
+// Every string has to end before the end of the file: the last byte of a file with strings is a NUL
+static int index_is_sane(){
+	uint64_t head;
+	uint32_t i;
+
+	head = sizeof(struct pidx_header) + (uint64_t) sizeof(struct pidx_dir) * HDR->ndirs + (uint64_t) sizeof(uint32_t) * HDR->nnames;
+	if(head > map_size || (head < map_size && map[map_size - 1] != '\0'))
+		return 0;
+	for(i = 0; i < HDR->ndirs; i++){
+		struct pidx_dir *d = &DIRS[i];
+		if(d->path < head || d->path >= map_size || (uint64_t) d->first + d->nnames > HDR->nnames)
+			return 0;
+	}
+	for(i = 0; i < HDR->nnames; i++)
+		if(NAMES[i] < head || NAMES[i] >= map_size)
+			return 0;
+	return 1;
+}
+
+// Maps the index file, returns 0 if it is not there, is broken, or is not an index of the given PATH
+static int map_index_file(struct pathlist *p){
+	struct stat st;
+	char *m;
+	int fd, i;
+
+	if(index_file == NULL || (fd = open(index_file, O_RDONLY | O_CLOEXEC)) < 0)
+		return 0;
+	if(fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(struct pidx_header)){
+		close(fd);
+		return 0;
+	}
+	m = (char *) mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(m == MAP_FAILED)
+		return 0;
+
+	map = m;
+	map_size = st.st_size;
+	map_is_file = 1;
+
+	if(memcmp(HDR->magic, PIDX_MAGIC, sizeof(HDR->magic)) != 0 || HDR->version != PIDX_VERSION || HDR->size != map_size ||
+	   HDR->ndirs != (uint32_t) p->count || !index_is_sane()){
+		unmap_index();
+		return 0;
+	}
+	for(i = 0; i < p->count; i++){
+		if(strcmp(map + DIRS[i].path, p->dirs[i]) != 0){
+			unmap_index();
+			return 0;
+		}
+	}
+	return 1;
+}
+
+// Checks if any indexed directory changed since it was read
+static int index_is_stale(){
+	struct stat st;
+	uint32_t i;
+
+	for(i = 0; i < HDR->ndirs; i++){
+		struct pidx_dir *d = &DIRS[i];
+		if(!d->indexed)
+			continue;
+		if(stat(map + d->path, &st) != 0){
+			if(d->ino != 0)
+				return 1;     // the directory is gone
+			continue;
+		}
+		if(d->ino != (uint64_t) st.st_ino || d->dev != (uint64_t) st.st_dev ||
+		   d->mtime_sec != (int64_t) st.st_mtim.tv_sec || d->mtime_nsec != (int64_t) st.st_mtim.tv_nsec)
+			return 1;
+	}
+	return 0;
+}
+
+// Writes the new index to a temporary file and renames it over the index file, so no shell ever sees half of it
+static int write_index_file(char *index, size_t size){
+	char *tmp;
+	size_t done = 0;
+	ssize_t n;
+	int fd;
+
+	if(index_file == NULL)
+		return 0;
+	tmp = (char *) malloc(strlen(index_file) + 8);
+	sprintf(tmp, "%s.XXXXXX", index_file);
+	if((fd = mkostemp(tmp, O_CLOEXEC)) < 0){
+		free(tmp);
+		return 0;
+	}
+	while(done < size && (n = write(fd, index + done, size - done)) > 0)
+		done += n;
+	fchmod(fd, 0644);
+	close(fd);
+	if(done != size || rename(tmp, index_file) != 0){
+		unlink(tmp);
+		free(tmp);
+		return 0;
+	}
+	free(tmp);
+	return 1;
+}
+
+/*
+ * Makes the index of the given PATH current: maps the index file, and reads again the directories that changed since it was written
+ * "rescan" reads every directory again
+ */
+static void load_index(struct pathlist *p, int rescan){
+	char *index;
+	size_t size;
+
+	if(index_file == NULL)
+		index_file = index_file_name(p);
+
+	if(map == NULL && !rescan && map_index_file(p) && !index_is_stale())
+		return;
+
+	// Build a new one, copying whatever is still valid from the old one
+	index = build_index(p, &size, rescan);
+	unmap_index();
+	if(write_index_file(index, size) && map_index_file(p)){
+		free(index);
+		return;
+	}
+
+	// Without a file, the index lives ONLY in this shell
+	map = index;
+	map_size = size;
+	map_is_file = 0;
+}
+
+static int need_rescan = 0;
+
+/*
+ * This function checks if a PATH directory changed, at most once a second, and updates the index if one did
+ * Returns 1 if the index changed, so anything looked up in it before may be wrong now
+ */
+int pathindex_revalidate(){
+	long long now = now_ns();
+
+	if(map == NULL || now - last_check_ns < REVALIDATE_NS)
+		return 0;
+	last_check_ns = now;
+	if(!index_is_stale())
+		return 0;
+
+	// Another shell may have updated the index file already
+	unmap_index();
+	load_index(get_path(), 0);
+	return 1;
+}
+
+// Loads the index if there is none yet
+static void ensure_index(){
+	if(map == NULL){
+		load_index(get_path(), need_rescan);
+		need_rescan = 0;
+		last_check_ns = now_ns();
+	}
+}
+
+// Checks that a file the index knows is executable for the shell, the same test access(X_OK) made before
+static int is_executable(struct pidx_dir *d, const char *name){
+	char path[PATH_MAX];
+
+	if(snprintf(path, sizeof(path), "%s/%s", map + d->path, name) >= (int) sizeof(path))
+		return 0;
+	return faccessat(AT_FDCWD, path, X_OK, AT_EACCESS) == 0;
+}
+
+/*
+ * This function tells if the executable "name" is in the directory number "dir" of PATH, from the index
+ * Returns 1 if it is, 0 if it is not, and -1 if the index doesn't know (a relative directory), so the caller has to check itself
+ * ONLY a name found in the index costs a system call, to check that it is (still) executable
+ */
+int pathindex_contains(int dir, const char *name){
+	struct pidx_dir *d;
+	int lo, hi, mid, r;
+
+	ensure_index();
+	if(dir < 0 || (uint32_t) dir >= HDR->ndirs || strchr(name, '/') != NULL)
+		return -1;
+
+	d = &DIRS[dir];
+	if(!d->indexed)
+		return -1;
+
+	lo = 0;
+	hi = (int) d->nnames - 1;
+	while(lo <= hi){
+		mid = lo + (hi - lo) / 2;
+		r = strcmp(name, map + NAMES[d->first + mid]);
+		if(r == 0)
+			return is_executable(d, name);
+		if(r < 0)
+			hi = mid - 1;
+		else
+			lo = mid + 1;
+	}
+	return 0;
+}
+
+/*
+ * This function calls "fn" for every executable of the directory number "dir" of PATH, in sorted order
+ * Each name of the index is checked with faccessat(...) relative to the directory, opened ONCE
+ * Returns the number of executables, or -1 if the directory is not indexed
+ */
+int pathindex_names(int dir, void (*fn)(const char *name, void *arg), void *arg){
+	struct pidx_dir *d;
+	uint32_t i;
+	int dirfd, n = 0;
+
+	ensure_index();
+	if(dir < 0 || (uint32_t) dir >= HDR->ndirs || !DIRS[dir].indexed)
+		return -1;
+
+	d = &DIRS[dir];
+	if(d->nnames == 0 || (dirfd = open(map + d->path, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) < 0)
+		return 0;
+	for(i = 0; i < d->nnames; i++){
+		const char *name = map + NAMES[d->first + i];
+		if(faccessat(dirfd, name, X_OK, AT_EACCESS) == 0){
+			fn(name, arg);
+			n++;
+		}
+	}
+	close(dirfd);
+	return n;
+}
+
+/*
+ * This function returns the generation of the index, which changes whenever the index changes
+ */
+unsigned int pathindex_generation(){
+	return generation;
+}
+
+/*
+ * This function forgets the index (PATH changed, or "rehash"), the next lookup reads every PATH directory again
+ */
+void pathindex_reset(){
+	unmap_index();
+	free(index_file);
+	index_file = NULL;
+	need_rescan = 1;
+}
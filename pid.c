@@ -9,7 +9,8 @@
 #include<stdio.h>
 #include<sys/types.h>
 #include<unistd.h>
+#include "sh.h"
 
 void process_id(){
-	printf("PID of the shell: %d\n",getpid());
+	out_printf(&shell_out, "PID of the shell: %d\n",getpid());
 }
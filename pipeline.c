@@ -0,0 +1,349 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that implements the piping functionality of our Shell for ANY number of commands
+ *   - Each "|" or "|&" between two commands is an edge of the pipeline and gets exactly ONE unnamed pipe
+ *   - Every child only keeps the pipe ends it actually uses, so EOF reaches the next command as soon as the previous one exits
+ *   - The shell waits on ALL the commands of the pipeline as one unit
+ *   - Every command is started with spawn_command(...) from "spawn.c"
+ *   - A built-in command can be a stage of the pipeline too ("printenv | grep PATH", "list /spool | wc -l"):
+ *       a built-in command that ONLY prints (BUILTIN_PURE) runs in the shell itself, without any fork(...):
+ *       its output goes into a memfd, so it never waits for the next command (which is not even started yet),
+ *       and from there into the pipe, right away if it fits, otherwise by a thread of the shell while the pipeline runs
+ *       any other built-in command ("cd", "setenv", ...) runs in a forked copy of the shell, a subshell,
+ *       so what it changes is thrown away with it, exactly like "(cd /tmp) | cat" in other shells
+ *       a pipeline in background ("&") forks EVERY built-in command, so the shell never runs one while it should not wait
+ *   - The pipeline is ONE job of the job table in "jobs.c", which also does the waiting
+ */
+
+#define _GNU_SOURCE
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include "sh.h"
+
+#define READ_END 0
+#define WRITE_END 1
+
+// Output of a built-in command that is still being written into the pipe by a thread
+struct pending_output {
+	int   from;    // memfd with the output
+	off_t off;
+	off_t len;
+	int   to;      // write end of the pipe, a copy owned by the thread
+	struct pending_output *next;
+};
+
+// Every output that a thread is still writing, so a subshell forked meanwhile can close the copies of the threads
+// Held across fork(...), so no thread closes its descriptors (and no new one is opened with the same number) while the child copies them
+static pthread_mutex_t writers_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct pending_output *writers = NULL;
+
+// Takes the output out of "writers" and closes its descriptors
+static void writer_done(struct pending_output *p){
+	struct pending_output **indirect;
+
+	pthread_mutex_lock(&writers_lock);
+	for(indirect = &writers; *indirect != NULL; indirect = &(*indirect)->next){
+		if(*indirect == p){
+			*indirect = p->next;
+			break;
+		}
+	}
+	close(p->from);
+	close(p->to);
+	pthread_mutex_unlock(&writers_lock);
+	free(p);
+}
+
+// Writes the rest of the output into the pipe, while the pipeline runs
+static void *output_thread(void *arg){
+	struct pending_output *p = (struct pending_output *) arg;
+	sigset_t mask;
+	ssize_t n;
+
+	// A reader that went away ("printenv | head -1") makes write(...) fail with EPIPE instead of killing the shell
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &mask, NULL);
+
+	while(p->off < p->len){
+		n = sendfile(p->to, p->from, &p->off, p->len - p->off);
+		if(n < 0 && errno == EINTR)
+			continue;
+		if(n <= 0)
+			break;
+	}
+	writer_done(p);
+	return NULL;
+}
+
+/*
+ * Sends the output of a built-in command from the memfd into the pipe to the next command
+ * The pipe is empty and nobody else writes into it, so a small output fits into it right away
+ * A bigger one is written by a detached thread, which closes its copy of the pipe when it is done (EOF for the next command)
+ */
+static void send_output(int memfd, int out_fd){
+	struct pending_output *p;
+	pthread_attr_t attr;
+	pthread_t tid;
+	off_t off = 0, len = lseek(memfd, 0, SEEK_END);
+	ssize_t n = 0;
+	int flags;
+
+	// The shell itself still has the read end open, so this write can't fail with EPIPE
+	flags = fcntl(out_fd, F_GETFL);
+	fcntl(out_fd, F_SETFL, flags | O_NONBLOCK);
+	while(off < len && (n = sendfile(out_fd, memfd, &off, len - off)) > 0);
+	fcntl(out_fd, F_SETFL, flags);
+
+	if(off >= len || (n < 0 && errno != EAGAIN)){
+		close(memfd);
+		return;
+	}
+
+	p = (struct pending_output *) malloc(sizeof(struct pending_output));
+	p->from = memfd;
+	p->off = off;
+	p->len = len;
+
+	// The copy is close-on-exec for the spawned commands, a forked subshell closes it itself (see fork_builtin_stage(...))
+	pthread_mutex_lock(&writers_lock);
+	p->to = fcntl(out_fd, F_DUPFD_CLOEXEC, 0);
+	p->next = writers;
+	writers = p;
+	pthread_mutex_unlock(&writers_lock);
+
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	if(pthread_create(&tid, &attr, output_thread, p) != 0){
+		fprintf(stderr, "pipeline: Failed to create thread, output of the built-in command is lost\n");
+		writer_done(p);
+	}
+	pthread_attr_destroy(&attr);
+}
+
+/*
+ * Runs a built-in command that ONLY prints as a stage of the pipeline, inside the shell itself
+ * Its STDOUT (and STDERR for "|&") goes into a memfd first, then into the pipe with send_output(...)
+ * The last command of the pipeline prints straight to the STDOUT of the shell
+ * Returns the exit status of the built-in command
+ */
+static int run_builtin_stage(const struct builtin *b, struct command *cmd, int in_fd, int out_fd, int err_to_out){
+	struct fd_plan plan;
+	int memfd = -1, status;
+
+	if(out_fd != -1 && (memfd = memfd_create("mysh-builtin", MFD_CLOEXEC)) < 0){
+		fprintf(stderr, "%s: %s.\n",cmd->argv[0],strerror(errno));
+		return 1;
+	}
+	if(redirect_builtin(&plan, cmd, in_fd, memfd, memfd != -1 && err_to_out) == -1){
+		if(memfd != -1)
+			close(memfd);
+		return 1;
+	}
+	status = call_builtin(b, cmd);
+	restore_builtin(&plan);
+
+	if(memfd != -1)
+		send_output(memfd, out_fd);
+	return status;
+}
+
+/*
+ * Runs any other built-in command as a stage of the pipeline in a forked copy of the shell (a subshell)
+ * The subshell is a command of the job like an external command: same process group, signals back to default
+ * Returns its PID, or -1 if it could not be started
+ *
+ * The shell may have other threads when it forks (output threads, the watchuser thread, the history index thread),
+ * and ONLY the forking thread exists in the child. A lock another thread held at that moment stays locked in the child forever:
+ *   - malloc(...) and stdio are safe, glibc takes their locks around fork(...)
+ *   - the pipe copies of the output threads are closed in the child, under "writers_lock" (else EOF would wait for the subshell)
+ *   - the watchuser readers are reset in the child by watchuser.c, so "watchuser" doesn't wait for a thread that is not there
+ *   - the built-in command must not call event_notify(...) (the watchuser thread may have held its lock), none of them does
+ * A new lock that threads take must be looked at here too
+ */
+static pid_t fork_builtin_stage(const struct builtin *b, struct command *cmd, int in_fd, int out_fd, int err_to_out, struct job *job){
+	struct fd_plan plan;
+	struct pending_output *p;
+	sigset_t none;
+	pid_t pid;
+	int status;
+	long long start;
+
+	// Anything the shell printed so far must not be printed again by the copy
+	out_sync();
+
+	start = stats_now();
+	pthread_mutex_lock(&writers_lock);
+	if((pid = fork()) < 0){
+		pthread_mutex_unlock(&writers_lock);
+		fprintf(stderr, "%s: %s.\n",cmd->argv[0],strerror(errno));
+		return -1;
+	}
+	if(pid == 0){
+		// The output of an earlier built-in command is the business of the thread in the shell, not of this copy
+		for(p = writers; p != NULL; p = p->next){
+			close(p->from);
+			close(p->to);
+		}
+		writers = NULL;
+		pthread_mutex_unlock(&writers_lock);
+
+		if(job_control)
+			setpgid(0, job->npids ? job->pgid : 0);
+		signal(SIGTTOU, SIG_DFL);
+		signal(SIGTTIN, SIG_DFL);
+		sigemptyset(&none);
+		sigprocmask(SIG_SETMASK, &none, NULL);
+
+		if(redirect_builtin(&plan, cmd, in_fd, out_fd, err_to_out) == -1)
+			_exit(1);
+		status = call_builtin(b, cmd);
+		out_sync();
+		_exit(status);
+	}
+
+	pthread_mutex_unlock(&writers_lock);
+	stats_record(PHASE_SPAWN, stats_now() - start);
+
+	// Set by both, so the process group exists whichever of them runs first
+	if(job_control)
+		setpgid(pid, job->npids ? job->pgid : pid);
+	return pid;
+}
+
+/*
+ * This function runs all the commands of the given pipeline and returns the exit status of the last command
+ * If the pipeline runs in background, then the shell does not wait for its commands
+ */
+int run_pipeline(struct pipeline *pl){
+	struct command *cmd;
+	struct job *job;
+	const struct builtin *builtin;
+	struct rusage self;   // usage of the shell before the commands start, for "time"
+	struct dir_cache *cache;   // directories read for the wildcards of ALL the commands, each one read ONCE
+	int     builtin_status = 0, last_builtin = 0;   // exit status of a built-in command run in the shell, if it was the last command
+	int     in_shell = 0;   // set if a built-in command ran in the shell itself
+	long long phase_start;  // start of a phase, for "stats"
+	char    *excmd;
+	pid_t   pid;
+	int     status, last_found = 1;       // set if the last command of the pipeline was found
+	int     prev_read = -1;       // read end of the pipe coming from the previous command
+	int     pipefd[2];
+
+	job = job_add(pl);
+	cache = dir_cache_new();
+	if(pl->timed)
+		getrusage(RUSAGE_SELF, &self);
+
+	for(cmd = pl->commands; cmd != NULL; cmd = cmd->next){
+
+		// Create an unnamed pipe for the edge between this command and the next one
+		// The last command of the pipeline keeps the STDOUT of the shell
+		// Both ends are close-on-exec, so ONLY the copies made for a command reach that command
+		pipefd[READ_END] = pipefd[WRITE_END] = -1;
+		if(cmd->next != NULL && pipe2(pipefd, O_CLOEXEC) == -1){
+			fprintf(stderr, "parent: Failed to create pipe\n");
+			break;
+		}
+
+		// A built-in command: in the shell if it ONLY prints (and the job is in foreground), otherwise in a subshell
+		phase_start = stats_now();
+		if((builtin = find_builtin(cmd->argv[0])) != NULL){
+			stats_record(PHASE_LOOKUP, stats_now() - phase_start);
+			if((builtin->flags & BUILTIN_PURE) && !pl->background){
+				builtin_status = run_builtin_stage(builtin, cmd, prev_read, pipefd[WRITE_END], cmd->stderr_to_pipe);
+				last_builtin = 1;
+				in_shell = 1;
+				last_found = 1;
+			}
+			else{
+				pid = fork_builtin_stage(builtin, cmd, prev_read, pipefd[WRITE_END], cmd->stderr_to_pipe, job);
+				if(pid > 0)
+					job_add_pid(job, pid);
+				last_builtin = 0;
+				last_found = (pid > 0);
+			}
+		}
+		// Look the command up in the shell, so that what was found in PATH is remembered for the next time
+		else if((excmd = find_command(cmd->argv[0])) == NULL){
+			stats_record(PHASE_LOOKUP, stats_now() - phase_start);
+			last_builtin = 0;
+
+			// A command on its own reports this on STDOUT, like it always did
+			fprintf(pl->ncommands == 1 ? stdout : stderr, "%s: Command not found\n",cmd->argv[0]);
+			last_found = 0;
+		}
+		else{
+			stats_record(PHASE_LOOKUP, stats_now() - phase_start);
+			last_builtin = 0;
+
+			// A foreground command on its own is announced before it starts
+			if(pl->ncommands == 1 && !pl->background){
+				printf("Executing [%s]\n",cmd->argv[0]);
+				fflush(stdout);
+			}
+
+			// STDIN comes from the previous command and STDOUT (and STDERR for "|&") goes into the next command
+			// Redirections of the command itself (e.g. "sort < file | uniq > out") are applied on top of the pipe
+			// Every command of the pipeline joins the process group of the job
+			pid = spawn_command(cmd, excmd, prev_read, pipefd[WRITE_END], cmd->stderr_to_pipe, job, cache);
+			if(pid > 0)
+				job_add_pid(job, pid);
+			last_found = (pid > 0);
+		}
+
+		// Parent doesn't need the pipe ends that were handed over to the command
+		// A command that could not be started still closes its ends, so its neighbours see EOF
+		if(prev_read != -1)
+			close(prev_read);
+		if(pipefd[WRITE_END] != -1)
+			close(pipefd[WRITE_END]);
+		prev_read = pipefd[READ_END];
+	}
+
+	// Read end of the last pipe would be left open if the pipeline stopped early
+	if(prev_read != -1)
+		close(prev_read);
+	dir_cache_free(cache);
+	job->starting = 0;
+
+	// What a built-in command used inside the shell is part of the job for "time"
+	if(pl->timed && in_shell)
+		rusage_self_since(&job->usage, &self);
+
+	// Nothing was started at all (or ONLY built-in commands that ran in the shell)
+	if(job->npids == 0){
+		job_remove(job);
+		return last_builtin ? builtin_status : 127;
+	}
+
+	if(pl->background){
+		if(pl->ncommands == 1)
+			printf("Background process number [%d] with pid [%d]\n",job->id,job->pgid);
+		else
+			printf("Background pipeline [%d] with pid [%d]\n",job->id,job->pids[job->npids - 1]);
+		return 0;
+	}
+
+	// Wait for EVERY command of this pipeline (and ONLY those) to finish
+	// The status of the pipeline is the status of its last command
+	phase_start = stats_now();
+	status = job_foreground(job, 0);
+	stats_record(PHASE_WAIT, stats_now() - phase_start);
+	if(last_builtin)
+		return builtin_status;
+	return last_found ? status : 127;
+}
@@ -7,10 +7,14 @@
  */
 
 #include<stdio.h>
+#include "sh.h"
 
 // This is a helper function for implementing both "printenv" and "setenv" commands functionality of our Shell
+// The variables go into the output buffer of the built-in commands, see "output.c"
 void printenv(char **envp){
         // Print ALL environment variable names with its associated values
-	for(int index = 0; envp[index] != NULL; index++)
-		printf("%s\n",envp[index]);
+	for(int index = 0; envp[index] != NULL; index++){
+		out_str(&shell_out, envp[index]);
+		out_add(&shell_out, "\n", 1);
+	}
 }
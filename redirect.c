@@ -0,0 +1,197 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that implements the File Redirection mechanism of our Shell from the redirection list of a command
+ *   - redirect_plan(...) turns the pipe ends and the redirections of a command into ONE ordered list of "fd operations",
+ *     each of them meaning "make file descriptor TARGET a copy of file descriptor SOURCE", exactly like dup2(SOURCE, TARGET)
+ *   - spawn_command(...) replays that list in the child as posix_spawn(...) file actions
+ *   - redirect_builtin(...) replays it in the shell itself for a built-in command, after saving every file descriptor it
+ *     changes with dup(...), and restore_builtin(...) puts the saved ones back with dup2(...)
+ *     (so nothing depends on "/dev/tty", and the shell works without a controlling terminal too)
+ */
+
+#define _GNU_SOURCE
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include "sh.h"
+
+// Saved copies of the file descriptors of the shell are kept above the ones a user would redirect
+#define SAVED_FD_MIN 10
+
+/*
+ * This function opens the file of the given redirection, taking "noclobber" into account
+ *   - With noclobber, ">" and ">&" refuse to overwrite an existing file and ">>" and ">>&" refuse to create a new file
+ *   - The check and the creation are ONE open(...) with O_EXCL, so a file created in between can't be overwritten
+ * Returns the new file descriptor (close-on-exec), or -1 if the file could not be opened (the error message is already printed)
+ */
+int open_redirection(struct redirection *r){
+	int fid, flags;
+
+	if(r->kind == REDIR_IN){   // "<"
+		fid = open(r->file, O_RDONLY | O_CLOEXEC);
+		if(fid < 0)
+			fprintf(stderr, "%s: No such file or directory.\n",r->file);
+		return fid;
+	}
+
+	if(r->kind == REDIR_OUT)  // ">" or ">&"
+		flags = noclobber ? O_WRONLY | O_CREAT | O_EXCL : O_WRONLY | O_CREAT | O_TRUNC;
+	else                      // ">>" or ">>&"
+		flags = noclobber ? O_WRONLY | O_APPEND : O_WRONLY | O_CREAT | O_APPEND;
+
+	fid = open(r->file, flags | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP);
+	if(fid < 0){
+		if(errno == EEXIST)          // noclobber refusing to overwrite
+			fprintf(stderr, "%s: File exists.\n",r->file);
+		else if(errno == ENOENT)     // noclobber refusing to create a new file (or a missing directory)
+			fprintf(stderr, "%s: No such file or directory.\n",r->file);
+		else
+			fprintf(stderr, "%s: Permission denied.\n",r->file);
+	}
+	return fid;
+}
+
+// Appends "dup2(source, target)" at the end of the plan
+static void plan_add(struct fd_plan *plan, int target, int source){
+	if(plan->nops == plan->cap){
+		plan->cap = plan->cap ? 2 * plan->cap : 8;
+		plan->ops = (struct fd_op *) realloc(plan->ops, sizeof(struct fd_op) * plan->cap);
+	}
+	plan->ops[plan->nops].target = target;
+	plan->ops[plan->nops].source = source;
+	plan->ops[plan->nops].saved  = -1;
+	plan->nops++;
+}
+
+/*
+ * This function builds the ordered list of fd operations of the given simple command into "plan"
+ *   - "in_fd" and "out_fd" are the pipe ends to use as STDIN and STDOUT of the command, or -1 to keep the ones of the shell
+ *   - "err_to_out" also sends STDERR into "out_fd" (for "|&")
+ *   - "skip_input" leaves out the "<" redirections (built-in commands don't read from STDIN)
+ * The pipe ends come first and the redirections of the command follow, in the order they were written
+ * Returns 0 on success and -1 if a file could not be opened, in which case the plan is already released
+ */
+int redirect_plan(struct fd_plan *plan, struct command *cmd, int in_fd, int out_fd, int err_to_out, int skip_input){
+	struct redirection *r;
+	int fid;
+
+	plan->ops = NULL;
+	plan->nops = plan->cap = 0;
+	plan->opened = NULL;
+	plan->nopened = 0;
+
+	// Set fd[0] (stdin) to the read end of the pipe from the previous command
+	if(in_fd != -1)
+		plan_add(plan, STDIN_FILENO, in_fd);
+
+	// Set fd[1] (stdout), and also fd[2] (stderr) for "|&", to the write end of the pipe to the next command
+	if(out_fd != -1){
+		plan_add(plan, STDOUT_FILENO, out_fd);
+		if(err_to_out)
+			plan_add(plan, STDERR_FILENO, out_fd);
+	}
+
+	for(r = cmd->redirs; r != NULL; r = r->next){
+		if(r->kind == REDIR_IN && skip_input)
+			continue;
+
+		// "N>&M" makes file descriptor N a copy of file descriptor M, as it is at this point of the list
+		if(r->kind == REDIR_DUP){
+			plan_add(plan, r->fd, r->dupfd);
+			continue;
+		}
+
+		// The shell opens the redirection files itself, so that errors (like noclobber refusing to overwrite) are reported here
+		if((fid = open_redirection(r)) < 0){
+			redirect_plan_free(plan);
+			return -1;
+		}
+		plan->opened = (int *) realloc(plan->opened, sizeof(int) * (plan->nopened + 1));
+		plan->opened[plan->nopened++] = fid;
+
+		plan_add(plan, r->fd, fid);
+		if(r->also_stderr)
+			plan_add(plan, STDERR_FILENO, fid);
+	}
+	return 0;
+}
+
+/*
+ * This function closes the files opened for the plan and frees it
+ */
+void redirect_plan_free(struct fd_plan *plan){
+	int i;
+
+	for(i = 0; i < plan->nopened; i++)
+		close(plan->opened[i]);
+	free(plan->opened);
+	free(plan->ops);
+	plan->opened = NULL;
+	plan->ops = NULL;
+	plan->nopened = plan->nops = plan->cap = 0;
+}
+
+/*
+ * This function applies the redirections of a built-in command to the shell itself
+ * "in_fd", "out_fd" and "err_to_out" are the pipe ends of a built-in command inside a pipeline, as for redirect_plan(...)
+ * Each file descriptor is saved with dup(...) the first time the plan changes it, so restore_builtin(...) can put it back
+ * Returns 0 on success and -1 if any redirection failed (everything is already restored in that case)
+ */
+int redirect_builtin(struct fd_plan *plan, struct command *cmd, int in_fd, int out_fd, int err_to_out){
+	int i, j;
+
+	// Anything already printed belongs to the old file descriptors
+	out_sync();
+
+	if(redirect_plan(plan, cmd, in_fd, out_fd, err_to_out, 1) == -1)
+		return -1;
+
+	for(i = 0; i < plan->nops; i++){
+		struct fd_op *op = &plan->ops[i];
+
+		// Save the file descriptor ONLY if no earlier operation of the plan has saved it already
+		for(j = 0; j < i && plan->ops[j].target != op->target; j++);
+		if(j == i){
+			op->saved = fcntl(op->target, F_DUPFD_CLOEXEC, SAVED_FD_MIN);
+			if(op->saved < 0)
+				op->saved = -2;   // the file descriptor was not open, it is closed again on restore
+		}
+
+		if(dup2(op->source, op->target) < 0){
+			fprintf(stderr, "%d: Bad file descriptor.\n",op->source);
+			plan->nops = i + 1;
+			restore_builtin(plan);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * This function puts back every file descriptor changed by redirect_builtin(...) and releases the plan
+ * The saved file descriptors are restored in reverse order, so each one gets back the value it had before the built-in command
+ */
+void restore_builtin(struct fd_plan *plan){
+	int i;
+
+	// Everything printed by the built-in command belongs to the redirected file descriptors
+	out_sync();
+
+	for(i = plan->nops - 1; i >= 0; i--){
+		struct fd_op *op = &plan->ops[i];
+		if(op->saved >= 0){
+			dup2(op->saved, op->target);
+			close(op->saved);
+		}
+		else if(op->saved == -2)
+			close(op->target);
+	}
+	redirect_plan_free(plan);
+}
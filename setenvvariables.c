@@ -3,70 +3,301 @@
  * Partner Name: James Cooper
  * Date: March 13th, 2021
  *
- * This is the simple program that just keeps track of whether the env variable is new or an existing one and modifies "dynamic envvariables"
+ * This is the program that keeps the environment variables of our Shell in "dynamic_envvariables"
  *   - If the env variable is new, then it will add it our global variable "dynamic_envvariables" at the end
  *   - However, if it's an existing one, then it will modify the value of existing env variable with the provided new value within "dynamic_envvariables"
+ *
+ * The variables are stored like this:
+ *   - Every "NAME=VALUE" string lives in ONE contiguous block of memory (the arena), one after another
+ *   - "dynamic_envvariables" is a growable NULL terminated array of pointers into the arena, in the order the variables were added
+ *   - An open-addressing hash table on the NAME gives the index of a variable in "dynamic_envvariables",
+ *     so finding, changing or removing a variable never scans the whole list
+ *   - A changed or removed variable leaves its old string behind in the arena, which is compacted once more than half of it is garbage
+ *   - Every change bumps "env_generation", and env_snapshot(...) gives the envp for the commands we start, rebuilt ONLY after a change
  */
 
 #include<stdio.h>
 #include<stdlib.h>
 #include<string.h>
+#include "sh.h"
+
 extern char **dynamic_envvariables;
 
-// This is a helper function for implementing "setenv" command functionality of our Shell
-void setenvvariable(char *varname,char *varvalue){
+#define SLOT_EMPTY    -1   // slot was never used
+#define SLOT_DELETED  -2   // slot held a variable that was removed (keeps probing going)
+
+// Definition for a slot of the hash table
+struct env_slot {
+	unsigned int hash;   // hash of the name of the variable
+	int          index;  // index of the variable in "dynamic_envvariables", or SLOT_EMPTY / SLOT_DELETED
+};
 
-	// Flag to keep track of same environmental name from list
-	int has_same_name = 0;
-
-	// Size of arg[1] and arg[2]	
-	int arg1len = (int) strlen(varname);
-	int arg2len = (int) strlen(varvalue);
-
-	// This is a variable to check if the environment variable name already exists
-	char namecheck[arg1len + 1];
-	strcpy(namecheck,varname);
-	int index = 0;
-	while(dynamic_envvariables[index] != NULL){
-		// Get the name of current environment variable(just the name and not both)
-		int namelen = 0;
-		for(int counter = 0; dynamic_envvariables[index][counter] != '='; counter++){
-			namelen++;
+static struct env_slot *slots;        // hash table, "nslots" is always a power of 2
+static int    nslots, nused_slots;    // size of the table and number of slots that are NOT empty (deleted slots included)
+static int    env_count, env_cap;     // number of variables and size of "dynamic_envvariables"
+static char  *arena;                  // "NAME=VALUE" strings, back to back
+static size_t arena_used, arena_size, arena_garbage;
+
+// Generation counter of the environment, bumped whenever a variable is added, changed or removed (or the arena moves)
+static unsigned long env_generation = 1;
+
+// envp handed to the commands, valid as long as "snapshot_generation" is equal to "env_generation"
+static char **snapshot;
+static int    snapshot_cap;
+static unsigned long snapshot_generation = 0;
+
+// FNV-1a hash of the first "len" characters of "name"
+static unsigned int hash_name(const char *name, size_t len){
+	unsigned int h = 2166136261u;
+	size_t i;
+	for(i = 0; i < len; i++){
+		h ^= (unsigned char) name[i];
+		h *= 16777619u;
+	}
+	return h;
+}
+
+// Length of the NAME part of a "NAME=VALUE" string
+static size_t name_length(const char *entry){
+	const char *eq = strchr(entry, '=');
+	return eq ? (size_t) (eq - entry) : strlen(entry);
+}
+
+/*
+ * Finds the slot of the variable with the given name
+ * Returns the slot of the variable if it exists, otherwise -1
+ * If "insert_at" is given, it gets the slot where the variable should be inserted when it doesn't exist
+ */
+static int find_slot(const char *name, size_t len, unsigned int h, int *insert_at){
+	int i = h & (nslots - 1), first_deleted = -1;
+
+	while(slots[i].index != SLOT_EMPTY){
+		if(slots[i].index == SLOT_DELETED){
+			if(first_deleted == -1)
+				first_deleted = i;
 		}
-		char *name = (char *) malloc(sizeof(char) * (namelen + 1));
-		strncpy(name,dynamic_envvariables[index],namelen);
-		name[namelen] = '\0';
-
-		// Compare both environment variable names to see if they are equal
-		// And if they are, then manage pointers for "dynamic_envvariables" and its current pointer value accordingly	 
-		// Treat "dynamic_envvariables" like a linked list to expand or shrink the size at runtime
-		if(strcmp(name,namecheck) == 0){
-			// Remove the current value for the environment variable before assigning a new one
-			free(dynamic_envvariables[index]);
-
-			// Allocate new space for the environment variable in heap memory
-			// Assign name and value for the environment variable
-			dynamic_envvariables[index] = (char *) malloc(sizeof(char) * (arg1len + arg2len + 2));
-			strcpy(dynamic_envvariables[index],varname);
-			strcat(dynamic_envvariables[index],"=");
-			strcat(dynamic_envvariables[index],varvalue);
-
-			has_same_name = 1;
+		else if(slots[i].hash == h){
+			char *entry = dynamic_envvariables[slots[i].index];
+			if(strncmp(entry, name, len) == 0 && entry[len] == '=')
+				return i;
 		}
-		// Free the local dyncamical allocation
+		i = (i + 1) & (nslots - 1);
+	}
+	if(insert_at)
+		*insert_at = (first_deleted != -1) ? first_deleted : i;
+	return -1;
+}
+
+// Builds the hash table again with "size" slots from "dynamic_envvariables" (also drops the deleted slots)
+static void rebuild_slots(int size){
+	int i, j;
+
+	free(slots);
+	slots = (struct env_slot *) malloc(sizeof(struct env_slot) * size);
+	nslots = size;
+	for(i = 0; i < nslots; i++)
+		slots[i].index = SLOT_EMPTY;
+
+	for(j = 0; j < env_count; j++){
+		size_t len = name_length(dynamic_envvariables[j]);
+		unsigned int h = hash_name(dynamic_envvariables[j], len);
+		for(i = h & (nslots - 1); slots[i].index != SLOT_EMPTY; i = (i + 1) & (nslots - 1));
+		slots[i].hash = h;
+		slots[i].index = j;
+	}
+	nused_slots = env_count;
+}
+
+/*
+ * Makes room for "need" more bytes in the arena
+ * The arena is either compacted (if more than half of it is garbage) or grown, and every pointer of "dynamic_envvariables" is moved along
+ */
+static void arena_reserve(size_t need){
+	char *new_arena;
+	size_t new_size, live;
+	int i;
+
+	if(arena_used + need <= arena_size)
+		return;
+
+	live = arena_used - arena_garbage;
+	new_size = arena_size ? arena_size : 4096;
+	while(new_size < 2 * (live + need))
+		new_size *= 2;
+
+	// Copy ONLY the live strings into the new arena, in the order of "dynamic_envvariables"
+	new_arena = (char *) malloc(new_size);
+	arena_used = 0;
+	for(i = 0; i < env_count; i++){
+		size_t len = strlen(dynamic_envvariables[i]) + 1;
+		memcpy(new_arena + arena_used, dynamic_envvariables[i], len);
+		dynamic_envvariables[i] = new_arena + arena_used;
+		arena_used += len;
+	}
+	free(arena);
+	arena = new_arena;
+	arena_size = new_size;
+	arena_garbage = 0;
+	env_generation++;
+}
+
+// Copies "NAME=VALUE" into the arena and returns where it is
+static char *arena_add(const char *name, const char *value){
+	size_t namelen = strlen(name), valuelen = strlen(value);
+	char *entry;
+
+	// The value may be the value of another variable (e.g. "OLDPWD" set from "PWD"), which moves along with the arena
+	if(value >= arena && value < arena + arena_used){
+		size_t offset = value - arena;
+		arena_reserve(namelen + valuelen + 2);
+		value = arena + offset;
+	}
+	else
+		arena_reserve(namelen + valuelen + 2);
+	entry = arena + arena_used;
+	memcpy(entry, name, namelen);
+	entry[namelen] = '=';
+	memcpy(entry + namelen + 1, value, valuelen + 1);
+	arena_used += namelen + valuelen + 2;
+	return entry;
+}
+
+/*
+ * This function fills "dynamic_envvariables" with the environment variables the shell was started with
+ */
+void env_init(char **envp){
+	int index;
+
+	env_count = 0;
+	env_cap = 64;
+	dynamic_envvariables = (char **) malloc(sizeof(char *) * env_cap);
+	dynamic_envvariables[0] = NULL;
+	rebuild_slots(128);
+
+	for(index = 0; envp[index] != NULL; index++){
+		char *eq = strchr(envp[index], '=');
+		if(eq == NULL)
+			continue;
+		char *name = strndup(envp[index], eq - envp[index]);
+		setenvvariable(name, eq + 1);
 		free(name);
-		index++;
 	}
+}
+
+/*
+ * This function returns the value of the environment variable with the given name, or NULL if there is no such variable
+ */
+char *env_get(const char *name){
+	size_t len = strlen(name);
+	int slot = find_slot(name, len, hash_name(name, len), NULL);
+
+	if(slot == -1)
+		return NULL;
+	return dynamic_envvariables[slots[slot].index] + len + 1;
+}
+
+// This is a helper function for implementing "setenv" command functionality of our Shell
+void setenvvariable(char *varname,char *varvalue){
+	size_t len = strlen(varname);
+	unsigned int h = hash_name(varname, len);
+	int slot, insert_at;
+	char *entry;
+
+	// Adding a string may move the arena, so the string is added BEFORE the slot is looked up
+	entry = arena_add(varname, varvalue);
+	slot = find_slot(varname, len, h, &insert_at);
+
+	// If the name already exists, then ONLY its string changes and the old one becomes garbage in the arena
+	if(slot != -1){
+		char *old = dynamic_envvariables[slots[slot].index];
+		arena_garbage += strlen(old) + 1;
+		dynamic_envvariables[slots[slot].index] = entry;
+		env_generation++;
+		return;
+	}
+
 	// If the name does not exist in environment variable list, then create a new environment variable at the end
-	if(dynamic_envvariables[index] == NULL && !has_same_name){
-		// Allocate a space for the new environment variable
-		// Assign name and a value for the new environment variable
-		dynamic_envvariables[index] = (char *) malloc(sizeof(char) * (arg1len + arg2len + 2));
-		strcpy(dynamic_envvariables[index],varname);
-		strcat(dynamic_envvariables[index],"=");
-		strcat(dynamic_envvariables[index],varvalue);
+	if(env_count + 1 >= env_cap){
+		env_cap *= 2;
+		dynamic_envvariables = (char **) realloc(dynamic_envvariables, sizeof(char *) * env_cap);
 	}
+	dynamic_envvariables[env_count] = entry;
+
+	if(slots[insert_at].index == SLOT_EMPTY)
+		nused_slots++;
+	slots[insert_at].hash = h;
+	slots[insert_at].index = env_count;
+	env_count++;
+
 	// Sets the next element of "dynamic_envvariables" to NULL for marking the end point
-	dynamic_envvariables[index + 1] = NULL;
+	dynamic_envvariables[env_count] = NULL;
+
+	// Keep the hash table at most half full
+	if(2 * nused_slots > nslots)
+		rebuild_slots(2 * env_count > nslots / 2 ? 2 * nslots : nslots);
 
+	env_generation++;
+}
+
+/*
+ * This is a helper function for implementing "unsetenv" command functionality of our Shell
+ * Returns 0 if the variable was removed and -1 if there was no such variable
+ */
+int unsetenvvariable(char *varname){
+	size_t len = strlen(varname);
+	int slot, index, i;
+
+	slot = find_slot(varname, len, hash_name(varname, len), NULL);
+	if(slot == -1)
+		return -1;
+
+	index = slots[slot].index;
+	arena_garbage += strlen(dynamic_envvariables[index]) + 1;
+	slots[slot].index = SLOT_DELETED;
+
+	// Keep the order of the other variables, so the ones after the removed variable move one place back
+	memmove(&dynamic_envvariables[index], &dynamic_envvariables[index + 1], sizeof(char *) * (env_count - index));
+	env_count--;
+	for(i = 0; i < nslots; i++)
+		if(slots[i].index > index)
+			slots[i].index--;
+
+	env_generation++;
+	return 0;
+}
+
+/*
+ * This function returns the NULL terminated envp that is passed to every command the shell starts
+ *   - It is a copy of "dynamic_envvariables" taken at the current generation, so it doesn't change under a command being started
+ *   - The strings are NOT copied: they stay in the arena until it is compacted, and compacting bumps the generation
+ *   - The copy is made again ONLY when the generation has changed since the last call (after "setenv", "unsetenv" or "cd")
+ */
+char **env_snapshot(){
+	if(snapshot_generation != env_generation){
+		if(env_count + 1 > snapshot_cap){
+			snapshot_cap = env_cap;
+			snapshot = (char **) realloc(snapshot, sizeof(char *) * snapshot_cap);
+		}
+		memcpy(snapshot, dynamic_envvariables, sizeof(char *) * (env_count + 1));
+		snapshot_generation = env_generation;
+	}
+	return snapshot;
+}
+
+/*
+ * This function frees all the dynamically allocated environment variables(env) from heap memory
+ */
+void free_dynamic_envvariables(){
+	free(arena);
+	free(slots);
+	free(dynamic_envvariables);
+	free(snapshot);
+	snapshot = NULL;
+	snapshot_cap = 0;
+	snapshot_generation = 0;
+	arena = NULL;
+	slots = NULL;
+	dynamic_envvariables = NULL;
+	arena_used = arena_size = arena_garbage = 0;
+	env_count = env_cap = nslots = nused_slots = 0;
 }
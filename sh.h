@@ -6,16 +6,320 @@
  * This is the simple header file that collects all the function prototypes and constants necessary for us to implement the Shell
  */
 
+#include <sys/types.h>
+#include <sys/resource.h>
+#include <time.h>
 #include "get_path.h"
 
 void process_id();
 void setenvvariable(char *varname, char *varvalue);
-char *which(char *command, struct pathelement *pathlist);
-char **where(char *command, struct pathelement *pathlist);
-void list(char *dir);
+int unsetenvvariable(char *varname);
+void env_init(char **envp);
+char **env_snapshot();
+void free_dynamic_envvariables();
+char *which(char *command, struct pathlist *pathlist);
+
+/* Options of the "list" command */
+struct list_opts
+{
+  int sort;          /* -s */
+  int long_format;   /* -l */
+  int classify;      /* -F */
+  int nul;           /* -0 */
+  int recursive;     /* -R */
+  int totals;        /* -T */
+};
+
+int list_dirs(char **dirs, int ndirs, struct list_opts *opts);
 void printenv(char **envp);
 
+/* Token types produced by lex_line(...) in "lexer.c" */
+#define TOK_WORD          0  /* a (possibly quoted) word      */
+#define TOK_PIPE          1  /* "|"                           */
+#define TOK_PIPE_ERR      2  /* "|&"                          */
+#define TOK_REDIR_IN      3  /* "<"                           */
+#define TOK_REDIR_OUT     4  /* ">"                           */
+#define TOK_REDIR_OUT_ERR 5  /* ">&"                          */
+#define TOK_APPEND        6  /* ">>"                          */
+#define TOK_APPEND_ERR    7  /* ">>&"                         */
+#define TOK_BG            8  /* "&"                           */
+#define TOK_SEMI          9  /* ";"                           */
+#define TOK_END          10  /* end of the command line       */
+
+struct token
+{
+  int   type;
+  char *text;   /* text of a TOK_WORD, NULL for operators */
+  int   fd;     /* file descriptor written before "<" or ">", -1 if none */
+  char *glob;   /* a TOK_WORD as a pattern (quoted wildcards escaped with \), NULL if it has no unquoted wildcards */
+};
+
+/* Kinds of redirection in the command tree (AST) */
+#define REDIR_IN      0  /* "<"           */
+#define REDIR_OUT     1  /* ">" and ">&"  */
+#define REDIR_APPEND  2  /* ">>" and ">>&" */
+#define REDIR_DUP     3  /* "N>&M"        */
+
+struct redirection
+{
+  int   kind;
+  int   fd;           /* file descriptor being redirected */
+  int   also_stderr;  /* set for ">&" and ">>&" */
+  int   dupfd;        /* file descriptor copied by "N>&M" */
+  char *file;
+  struct redirection *next;  /* redirections are kept in the order they were written */
+};
+
+/* Simple command: words and redirections */
+struct command
+{
+  char **argv;        /* NULL terminated list of words */
+  char **glob;        /* glob[i] is argv[i] as a pattern, NULL if argv[i] has no unquoted wildcards */
+  int    argc;
+  int    cap;
+  struct redirection *redirs;
+  int    stderr_to_pipe;  /* set if this command is followed by "|&" */
+  struct command *next;   /* next command of the pipeline */
+};
+
+/* Pipeline: simple commands joined by "|" or "|&" */
+struct pipeline
+{
+  struct command  *commands;
+  int              ncommands;
+  int              background;  /* set if the pipeline ends with "&" */
+  int              timed;       /* TIME_HUMAN or TIME_MACHINE if the pipeline starts with "time", 0 otherwise */
+  struct pipeline *next;        /* next pipeline of the command line */
+};
+
+/* Reports of the "time" prefix, see "timecmd.c" */
+#define TIME_HUMAN    1  /* "time": TIMEFORMAT, or several lines for people */
+#define TIME_MACHINE  2  /* "time -m": ONE line of "name=value" pairs */
+
+struct token *lex_line(const char *line);
+void free_tokens(struct token *tokens, int ntokens);
+struct pipeline *parse_line(const char *line);
+void free_pipelines(struct pipeline *pl);
+int run_pipeline(struct pipeline *pl);
+void spawn_print_stats();
+
+/* Arguments of a command after wildcard expansion, of ANY number */
+struct arglist
+{
+  char **argv;       /* NULL terminated */
+  char  *allocated;  /* allocated[i] is set if argv[i] was allocated by expand_args(...) */
+  int    argc;
+  int    cap;
+};
+
+struct dir_cache;   /* directories read for wildcard expansion, see "wildcard.c" */
+
+struct dir_cache *dir_cache_new();
+void dir_cache_free(struct dir_cache *c);
+int expand_args(struct command *cmd, struct arglist *args, struct dir_cache *cache);
+void free_args(struct arglist *args);
+
+/* One fd operation of a redirection plan: "dup2(source, target)" */
+struct fd_op
+{
+  int target;
+  int source;
+  int saved;   /* copy of "target" saved by redirect_builtin(...), -1 if not saved by this operation, -2 if "target" was not open */
+};
+
+/* Ordered list of fd operations of a simple command, together with the files opened for it */
+struct fd_plan
+{
+  struct fd_op *ops;
+  int    nops, cap;
+  int   *opened;
+  int    nopened;
+};
+
+int open_redirection(struct redirection *r);
+int redirect_plan(struct fd_plan *plan, struct command *cmd, int in_fd, int out_fd, int err_to_out, int skip_input);
+void redirect_plan_free(struct fd_plan *plan);
+int redirect_builtin(struct fd_plan *plan, struct command *cmd, int in_fd, int out_fd, int err_to_out);
+void restore_builtin(struct fd_plan *plan);
+char *hash_lookup(char *command);
+char *find_command(char *command);
+void rehash();
+void hash_reset_counters();
+void hash_print();
+
+
+/* Job of the job table, see "jobs.c" */
+#define JOB_RUNNING 0
+#define JOB_STOPPED 1
+#define JOB_DONE    2
+
+struct job
+{
+  int    id;            /* job number, "%n" */
+  pid_t  pgid;          /* process group of the job (PID of its first command) */
+  pid_t *pids;          /* PIDs of the commands of the job */
+  int   *pstate;        /* state of each command */
+  int   *pidfds;        /* pidfd of each command for the event loop, -1 if none */
+  int    npids;
+  int    state;         /* JOB_RUNNING, JOB_STOPPED or JOB_DONE */
+  int    status;        /* exit status of the last command of the job */
+  int    background;
+  int    notified;      /* set once the user was told that the job stopped */
+  int    starting;      /* set while run_pipeline(...) is still starting its commands */
+  int    timed;         /* "time" report printed when the job is removed, 0 if none */
+  struct rusage usage;  /* what the processes of the job used, added up as they are reaped */
+  struct timespec started;
+  struct timespec finished;   /* when its last process was reaped */
+  char  *text;          /* command line of the job for "jobs" */
+  struct job *next;
+};
+
+pid_t spawn_command(struct command *cmd, char *excmd, int in_fd, int out_fd, int err_to_out, struct job *job, struct dir_cache *cache);
+void jobs_init();
+struct job *job_add(struct pipeline *pl);
+void job_add_pid(struct job *job, pid_t pid);
+void job_remove(struct job *job);
+void jobs_reap();
+int job_wait(struct job *job);
+int job_foreground(struct job *job, int cont);
+void job_background(struct job *job);
+struct job *job_find(char *name, char *builtin);
+struct job *job_find_quiet();
+void jobs_print(int with_pids);
+void rusage_add(struct rusage *sum, const struct rusage *ru);
+void rusage_self_since(struct rusage *sum, const struct rusage *before);
+void time_report(int mode, const struct timespec *started, const struct timespec *finished, const struct rusage *ru);
+int jobs_changed();
+void jobs_notify(int verbose);
+int jobs_wait(struct job *job);
+
+/* Built-in command: every handler takes the simple command and returns its exit status */
+#define BUILTIN_QUIET 1  /* don't print "Executing built-in [...]" */
+#define BUILTIN_PURE  2  /* ONLY prints, never changes the shell: inside a pipeline it runs in the shell itself,
+                            any other built-in command runs in a forked copy of the shell (a subshell) */
+
+struct builtin
+{
+  const char *name;
+  int (*handler)(struct command *cmd);
+  int flags;
+};
+
+const struct builtin *find_builtin(const char *name);
+const char *builtin_name(int i);
+int run_builtin(const struct builtin *b, struct command *cmd);
+int call_builtin(const struct builtin *b, struct command *cmd);
+void outstat_print();
+
+void addUser(char *username);
+void removeUser(char *username);
+int searchUser(char *username);
+void watchuser_start();
+void watchuser_stop();
+void watchuser_set_window(int ms);
+int watchuser_get_window();
+
+/* Buffered reader of command lines, see "input.c" */
+struct reader
+{
+  int    fd;           /* -1 for a reader made from a string */
+  char  *buf;
+  size_t start, end, cap;
+  char  *line;         /* current line, grows as needed */
+  size_t linecap;
+};
+
+void reader_init(struct reader *rd, int fd);
+void reader_init_string(struct reader *rd, const char *text);
+char *read_line(struct reader *rd);
+char *reader_take_line(struct reader *rd, int at_eof);
+ssize_t reader_fill(struct reader *rd);
+void reader_discard(struct reader *rd);
+void reader_free(struct reader *rd);
+int reader_stdin_line(char *buf, size_t size);
+void event_init(int fd, int interactive);
+int event_watch_child(pid_t pid);
+void event_notify(const char *text);
+int event_drain(int at_prompt);
+char *event_read_line(struct reader *rd);
+void print_prompt();
+
+/* Command history, see "history.c" */
+void history_init();
+void history_add(const char *line, time_t started, long duration_ms, int status);
+long history_first();
+long history_last();
+const char *history_line(long seq);
+long history_search(const char *query, long before, int anchored);
+char *history_expand(const char *line);
+void history_print(long count, int verbose);
+
+/* TAB completion, see "complete.c" */
+struct candidate
+{
+  const char   *name;
+  unsigned char type;   /* DT_DIR for a directory */
+};
+
+struct completion
+{
+  char   quote;         /* open quote of the word at the cursor, 0 if none */
+  char  *prefix;        /* part of the word that the names of the candidates start with */
+  struct candidate *v;  /* sorted */
+  int    n, cap;
+};
+
+int complete(const char *line, size_t pos, struct completion *c);
+void completion_free(struct completion *c);
+
+/* Output buffer of the built-in commands, see "output.c" */
+struct outbuf
+{
+  char  *buf;
+  size_t len;
+  size_t cap;
+  int    fd;           /* -1 for a buffer that grows instead of being written out */
+  unsigned long long bytes;   /* written out so far */
+  unsigned long      writes;  /* system calls it took */
+};
+
+extern struct outbuf shell_out;   /* STDOUT of the shell */
+
+void out_add(struct outbuf *ob, const char *s, size_t len);
+void out_str(struct outbuf *ob, const char *s);
+void out_printf(struct outbuf *ob, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+void out_flush(struct outbuf *ob);
+void out_sync();
+
+/* Latency of the phases of a command line, see "stats.c" */
+#define PHASE_READ    0
+#define PHASE_PARSE   1
+#define PHASE_LOOKUP  2
+#define PHASE_GLOB    3
+#define PHASE_SPAWN   4
+#define PHASE_EXEC    5
+#define PHASE_WAIT    6
+#define PHASE_PROMPT  7
+#define NPHASES       8
+
+long long stats_now();
+void stats_record(int phase, long long ns);
+void stats_record_builtin(int i, long long ns);
+void stats_print();
+void stats_reset();
+
+/* Line editor of the interactive shell, see "lineedit.c" */
+int edit_begin();
+char *edit_process(struct reader *rd, int *eof);
+void edit_redraw();
+void edit_discard();
+void edit_end();
+
+extern int noclobber;
+extern int job_control;
+extern int exit_shell;
+extern int prompt_command_flag;
+extern char prompt_command_prefix[];
+
 #define PROMPTMAX 64
-#define MAXARGS   16
 #define MAXLINE   128
-#define MAXENVVARIABLES 128
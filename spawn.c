@@ -0,0 +1,138 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that starts external commands for our Shell with posix_spawn(...) instead of fork(...) + execve(...)
+ *   - posix_spawn(...) does not copy the page tables of the shell (glibc uses clone(CLONE_VM|CLONE_VFORK) for it),
+ *     so starting a command does not get slower as the shell grows
+ *   - EVERYTHING that used to run in the child (wildcard expansion, see "wildcard.c", opening redirection files) is done by the shell itself,
+ *     and the child only replays a list of dup2(...) "file actions" before it executes the command
+ *   - The time taken by each posix_spawn(...) is measured and can be printed with the "spawnstat" command
+ */
+
+#define _GNU_SOURCE
+#include <unistd.h>
+#include <sys/types.h>
+#include <spawn.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include "sh.h"
+
+// Latency of posix_spawn(...) calls in nanoseconds
+static long spawn_count = 0;
+static long long spawn_total_ns = 0, spawn_max_ns = 0, spawn_last_ns = 0;
+
+static long long now_ns(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*
+ * This function starts the given simple command in a new process and returns its PID, or -1 if it could not be started
+ *   - "excmd" is the executable found for the command by find_command(...)
+ *   - "in_fd" and "out_fd" are the pipe ends to use as STDIN and STDOUT of the command, or -1 to keep the ones of the shell
+ *   - "err_to_out" also sends STDERR into "out_fd" (for "|&")
+ *   - "job" is the job the command belongs to: with job control, the command joins the process group of the job
+ *     (the first command of the job creates it), and the command of a foreground job gets the terminal
+ *   - "cache" is the directory cache of the pipeline, for wildcard expansion
+ * The redirections of the command are applied on top of the pipe ends, in the order they were written
+ */
+pid_t spawn_command(struct command *cmd, char *excmd, int in_fd, int out_fd, int err_to_out, struct job *job, struct dir_cache *cache){
+	posix_spawn_file_actions_t actions;
+	posix_spawnattr_t attr;
+	sigset_t sigdefault, sigmask;
+	short   flags;
+	struct arglist args;       // arguments of the command after wildcard expansion
+	struct fd_plan plan;       // dup2(...) operations of the command and the redirection files opened for it
+	pid_t   pid;
+	int     err, i;
+	long long start;
+
+	start = stats_now();
+	expand_args(cmd, &args, cache);
+	stats_record(PHASE_GLOB, stats_now() - start);
+	start = stats_now();
+
+	// The pipe ends and the redirections become ONE ordered list of dup2(...) operations, see "redirect.c"
+	// The shell opens the redirection files itself, so that errors (like noclobber refusing to overwrite) are reported here
+	// Opened files are close-on-exec, ONLY their dup2(...) copies reach the command
+	if(redirect_plan(&plan, cmd, in_fd, out_fd, err_to_out, 0) == -1){
+		free_args(&args);
+		return -1;
+	}
+
+	posix_spawn_file_actions_init(&actions);
+
+#if __GLIBC_PREREQ(2, 35)
+	// The command of a foreground job takes the terminal itself before it runs (and before STDIN is redirected),
+	// so it can't read from the terminal before the shell gives it away
+	if(job_control && job != NULL && !job->background)
+		posix_spawn_file_actions_addtcsetpgrp_np(&actions, STDIN_FILENO);
+#endif
+	for(i = 0; i < plan.nops; i++)
+		posix_spawn_file_actions_adddup2(&actions, plan.ops[i].source, plan.ops[i].target);
+
+	// The shell ignores SIGTTOU and SIGTTIN for job control and blocks the signals it reads from its signalfd,
+	// the command must NOT inherit any of that
+	posix_spawnattr_init(&attr);
+	sigemptyset(&sigdefault);
+	sigaddset(&sigdefault, SIGTTOU);
+	sigaddset(&sigdefault, SIGTTIN);
+	posix_spawnattr_setsigdefault(&attr, &sigdefault);
+	sigemptyset(&sigmask);
+	posix_spawnattr_setsigmask(&attr, &sigmask);
+	flags = POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK;
+
+	if(job_control && job != NULL){
+		flags |= POSIX_SPAWN_SETPGROUP;
+		posix_spawnattr_setpgroup(&attr, job->npids ? job->pgid : 0);
+	}
+	posix_spawnattr_setflags(&attr, flags);
+
+	stats_record(PHASE_SPAWN, stats_now() - start);
+
+	start = now_ns();
+	// The environment of the shell is handed over as it is, env_snapshot(...) ONLY copies it after it was changed
+	err = posix_spawn(&pid, excmd, &actions, &attr, args.argv, env_snapshot());
+	spawn_last_ns = now_ns() - start;
+	stats_record(PHASE_EXEC, spawn_last_ns);
+
+	spawn_count++;
+	spawn_total_ns += spawn_last_ns;
+	if(spawn_last_ns > spawn_max_ns)
+		spawn_max_ns = spawn_last_ns;
+
+	if(err != 0){
+		fprintf(stderr, "%s: %s.\n",cmd->argv[0],strerror(err));
+		pid = -1;
+	}
+
+	// The shell doesn't need the redirection files anymore
+	redirect_plan_free(&plan);
+
+	posix_spawn_file_actions_destroy(&actions);
+	posix_spawnattr_destroy(&attr);
+	free_args(&args);
+	return pid;
+}
+
+/*
+ * This is the helper function for implementing "spawnstat" command
+ * It prints how long it took to start the external commands
+ */
+void spawn_print_stats(){
+	if(spawn_count == 0){
+		out_str(&shell_out, "spawnstat: No commands started yet.\n");
+		return;
+	}
+	out_printf(&shell_out, "commands started: %ld\n", spawn_count);
+	out_printf(&shell_out, "last spawn:       %lld us\n", spawn_last_ns / 1000);
+	out_printf(&shell_out, "average spawn:    %lld us\n", spawn_total_ns / spawn_count / 1000);
+	out_printf(&shell_out, "max spawn:        %lld us\n", spawn_max_ns / 1000);
+}
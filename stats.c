@@ -0,0 +1,173 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that keeps the latency of every phase of a command line, for the "stats" command
+ *   - The phases between ENTER and the command running are timed with CLOCK_MONOTONIC where they happen:
+ *       read     handing the command line over (from the wakeup of the last key, or read_line(...) for a script)
+ *       parse    building the command tree (AST)
+ *       lookup   finding the built-in command, or the command in PATH (see "hashcmd.c")
+ *       glob     wildcard expansion of the arguments
+ *       spawn    preparing the command: redirections and posix_spawn(...) attributes, fork(...) of a subshell
+ *       exec     posix_spawn(...) itself, which returns once the child called execve(...)
+ *       wait     the foreground job running until it is done or stopped
+ *       prompt   printing the prompt
+ *     and every built-in command is timed too, from its handler starting until its output is written out
+ *   - Each one goes into a histogram like HDR histograms: 16 buckets for every power of 2 of nanoseconds,
+ *     so any latency from 1 ns to hours is kept with at most 1/16 (about 6%) of error, in a fixed amount of memory,
+ *     and recording a latency never allocates anything (except the first time a built-in command runs)
+ *   - "stats" prints the count, p50, p99 and max of every phase and built-in command, "stats reset" clears them
+ */
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sh.h"
+
+#define SUB_BITS  4
+#define SUB_COUNT (1 << SUB_BITS)                    // buckets for every power of 2
+#define NBUCKETS  ((64 - SUB_BITS + 1) * SUB_COUNT)  // enough for ANY 64 bit value
+
+struct histogram {
+	unsigned long count;
+	long long     max;
+	unsigned int  buckets[NBUCKETS];
+};
+
+static const char *phase_names[NPHASES] = { "read", "parse", "lookup", "glob", "spawn", "exec", "wait", "prompt" };
+
+static struct histogram phases[NPHASES];
+static struct histogram **builtins = NULL;   // by the number of the built-in command, allocated when it first runs
+static int nbuiltins = 0;
+
+/*
+ * This function returns the time of CLOCK_MONOTONIC in nanoseconds
+ */
+long long stats_now(){
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Bucket of a value: values below 16 have their own bucket,
+// others are split by their highest bit and the 4 bits after it
+static int bucket_of(unsigned long long v){
+	int e;
+
+	if(v < SUB_COUNT)
+		return (int) v;
+	e = 63 - __builtin_clzll(v);
+	return (e - SUB_BITS + 1) * SUB_COUNT + (int) ((v >> (e - SUB_BITS)) - SUB_COUNT);
+}
+
+// Largest value that falls into the bucket
+static long long bucket_top(int i){
+	int e;
+
+	if(i < SUB_COUNT)
+		return i;
+	e = i / SUB_COUNT + SUB_BITS - 1;
+	return ((long long) (SUB_COUNT + i % SUB_COUNT + 1) << (e - SUB_BITS)) - 1;
+}
+
+static void record(struct histogram *h, long long ns){
+	if(ns < 0)
+		ns = 0;
+	h->buckets[bucket_of(ns)]++;
+	h->count++;
+	if(ns > h->max)
+		h->max = ns;
+}
+
+// Value below which the fraction "p" of the recorded values are, never more than the max
+static long long percentile(struct histogram *h, double p){
+	unsigned long rank = (unsigned long) (p * h->count + 0.999999), seen = 0;
+	int i;
+
+	if(rank == 0)
+		rank = 1;
+	for(i = 0; i < NBUCKETS; i++){
+		seen += h->buckets[i];
+		if(seen >= rank)
+			return bucket_top(i) < h->max ? bucket_top(i) : h->max;
+	}
+	return h->max;
+}
+
+/*
+ * This function records the latency of one phase, in nanoseconds
+ */
+void stats_record(int phase, long long ns){
+	record(&phases[phase], ns);
+}
+
+/*
+ * This function records how long the built-in command number "i" (in alphabetical order) took, in nanoseconds
+ */
+void stats_record_builtin(int i, long long ns){
+	if(i >= nbuiltins){
+		builtins = (struct histogram **) realloc(builtins, sizeof(struct histogram *) * (i + 1));
+		memset(builtins + nbuiltins, 0, sizeof(struct histogram *) * (i + 1 - nbuiltins));
+		nbuiltins = i + 1;
+	}
+	if(builtins[i] == NULL)
+		builtins[i] = (struct histogram *) calloc(1, sizeof(struct histogram));
+	record(builtins[i], ns);
+}
+
+// Prints a latency with a unit that keeps it short
+static void format_ns(char *buf, size_t size, long long ns){
+	if(ns < 1000)
+		snprintf(buf, size, "%lldns", ns);
+	else if(ns < 1000000)
+		snprintf(buf, size, "%.1fus", ns / 1e3);
+	else if(ns < 1000000000)
+		snprintf(buf, size, "%.2fms", ns / 1e6);
+	else
+		snprintf(buf, size, "%.2fs", ns / 1e9);
+}
+
+static void print_row(const char *name, struct histogram *h){
+	char p50[32], p99[32], max[32];
+
+	format_ns(p50, sizeof(p50), percentile(h, 0.50));
+	format_ns(p99, sizeof(p99), percentile(h, 0.99));
+	format_ns(max, sizeof(max), h->max);
+	out_printf(&shell_out, "%-10s %8lu %10s %10s %10s\n", name, h->count, p50, p99, max);
+}
+
+/*
+ * This is the helper function for implementing "stats" command
+ * It prints the count, p50, p99 and max of every phase and of every built-in command that ran, ONLY the ones with a count
+ */
+void stats_print(){
+	int i;
+
+	out_printf(&shell_out, "%-10s %8s %10s %10s %10s\n", "phase", "count", "p50", "p99", "max");
+	for(i = 0; i < NPHASES; i++)
+		if(phases[i].count > 0)
+			print_row(phase_names[i], &phases[i]);
+
+	out_printf(&shell_out, "\n%-10s %8s %10s %10s %10s\n", "built-in", "count", "p50", "p99", "max");
+	for(i = 0; i < nbuiltins; i++)
+		if(builtins[i] != NULL)
+			print_row(builtin_name(i), builtins[i]);
+}
+
+/*
+ * This is the helper function for implementing "stats reset" command
+ * It clears every histogram
+ */
+void stats_reset(){
+	int i;
+
+	memset(phases, 0, sizeof(phases));
+	for(i = 0; i < nbuiltins; i++){
+		free(builtins[i]);
+		builtins[i] = NULL;
+	}
+}
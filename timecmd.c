@@ -0,0 +1,152 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that implements the "time" prefix of our Shell ("time [-m] pipeline")
+ *   - The job table reaps every child with wait4(...) and adds up what it used into the job (see "jobs.c"),
+ *     built-in commands that run inside the shell add what the shell itself used meanwhile (getrusage(...))
+ *   - When the job is done, time_report(...) prints to STDERR the wall clock time (from CLOCK_MONOTONIC),
+ *     the user and system CPU time, the max RSS, the major and minor page faults and the voluntary and involuntary
+ *     context switches
+ *   - The max RSS of an external command is never below the resident size of the shell: posix_spawn(...) shares the memory
+ *     of the shell until execve(...), and the kernel keeps the peak of the memory a process had before execve(...)
+ *   - The report follows TIMEFORMAT if it is set, "time -m" prints ONE line of "name=value" pairs for scripts instead
+ *   - TIMEFORMAT works like in bash, and has some more letters:
+ *       %[p][l]R   wall clock time, %[p][l]U user time, %[p][l]S system time, with "p" digits after the point (0 to 3)
+ *                  and with "l" in the "1m2.345s" form
+ *       %P         CPU usage in percent ((user + system) / wall clock)
+ *       %M         max RSS in KB
+ *       %F and %f  major and minor page faults
+ *       %w and %c  voluntary and involuntary context switches
+ *       %%         a "%"
+ *     "\n" and "\t" in TIMEFORMAT are a newline and a tab, since a newline can't be typed into "setenv"
+ */
+
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <stdio.h>
+#include <time.h>
+#include "sh.h"
+
+#define TIME_REPORTMAX 1024
+
+// Report of "time" without TIMEFORMAT, and of "time -m"
+static const char human_format[] = "real\t%3lR\nuser\t%3lU\nsys\t%3lS\nmaxrss\t%M KB\n"
+				   "faults\t%F major, %f minor\nswitches\t%w voluntary, %c involuntary";
+static const char machine_format[] = "real=%3R user=%3U sys=%3S cpu=%P maxrss_kb=%M majflt=%F minflt=%f nvcsw=%w nivcsw=%c";
+
+/*
+ * This function adds the usage of a process to "sum"
+ * Times and counts add up, the max RSS is the largest one
+ */
+void rusage_add(struct rusage *sum, const struct rusage *ru){
+	timeradd(&sum->ru_utime, &ru->ru_utime, &sum->ru_utime);
+	timeradd(&sum->ru_stime, &ru->ru_stime, &sum->ru_stime);
+	if(ru->ru_maxrss > sum->ru_maxrss)
+		sum->ru_maxrss = ru->ru_maxrss;
+	sum->ru_majflt += ru->ru_majflt;
+	sum->ru_minflt += ru->ru_minflt;
+	sum->ru_nvcsw  += ru->ru_nvcsw;
+	sum->ru_nivcsw += ru->ru_nivcsw;
+}
+
+/*
+ * This function adds to "sum" what the shell itself used since getrusage(RUSAGE_SELF, before)
+ */
+void rusage_self_since(struct rusage *sum, const struct rusage *before){
+	struct rusage now;
+
+	getrusage(RUSAGE_SELF, &now);
+	timersub(&now.ru_utime, &before->ru_utime, &now.ru_utime);
+	timersub(&now.ru_stime, &before->ru_stime, &now.ru_stime);
+	now.ru_majflt -= before->ru_majflt;
+	now.ru_minflt -= before->ru_minflt;
+	now.ru_nvcsw  -= before->ru_nvcsw;
+	now.ru_nivcsw -= before->ru_nivcsw;
+	rusage_add(sum, &now);
+}
+
+// Appends a time in seconds with "precision" digits after the point, in the "1m2.345s" form for "long_form"
+static int put_seconds(char *out, size_t size, double seconds, int precision, int long_form){
+	long minutes;
+
+	if(!long_form)
+		return snprintf(out, size, "%.*f", precision, seconds);
+	minutes = (long) (seconds / 60);
+	return snprintf(out, size, "%ldm%.*fs", minutes, precision, seconds - minutes * 60.0);
+}
+
+/*
+ * This function prints the report of "time" for a job that ran from "started" to "finished" and used "ru"
+ * "mode" is TIME_HUMAN (TIMEFORMAT if it is set) or TIME_MACHINE ("time -m")
+ * The report goes to STDERR (which is not buffered) at once, so it is not mixed up with the output of other jobs
+ */
+void time_report(int mode, const struct timespec *started, const struct timespec *finished, const struct rusage *ru){
+	char out[TIME_REPORTMAX];
+	const char *format, *f, *directive;
+	double real, user, sys;
+	int len = 0, n, precision, long_form;
+
+	real = (finished->tv_sec - started->tv_sec) + (finished->tv_nsec - started->tv_nsec) / 1e9;
+	user = ru->ru_utime.tv_sec + ru->ru_utime.tv_usec / 1e6;
+	sys  = ru->ru_stime.tv_sec + ru->ru_stime.tv_usec / 1e6;
+
+	// An empty TIMEFORMAT prints nothing at all, like in bash
+	format = mode == TIME_MACHINE ? machine_format : env_get("TIMEFORMAT");
+	if(format == NULL)
+		format = human_format;
+	if(*format == '\0')
+		return;
+
+	for(f = format; *f && len < TIME_REPORTMAX - 1; f++){
+		if(*f == '\\' && (f[1] == 'n' || f[1] == 't')){
+			out[len++] = *++f == 'n' ? '\n' : '\t';
+			continue;
+		}
+		if(*f != '%' || f[1] == '\0'){
+			out[len++] = *f;
+			continue;
+		}
+		directive = ++f;
+		precision = 3;
+		long_form = 0;
+		if(*f >= '0' && *f <= '9'){
+			precision = *f - '0' > 3 ? 3 : *f - '0';
+			f++;
+		}
+		if(*f == 'l'){
+			long_form = 1;
+			f++;
+		}
+
+		n = 0;
+		switch(*f){
+			case 'R': n = put_seconds(out + len, TIME_REPORTMAX - len, real, precision, long_form); break;
+			case 'U': n = put_seconds(out + len, TIME_REPORTMAX - len, user, precision, long_form); break;
+			case 'S': n = put_seconds(out + len, TIME_REPORTMAX - len, sys, precision, long_form); break;
+			case 'P': n = snprintf(out + len, TIME_REPORTMAX - len, "%.2f", real > 0 ? (user + sys) * 100 / real : 0.0); break;
+			case 'M': n = snprintf(out + len, TIME_REPORTMAX - len, "%ld", ru->ru_maxrss); break;
+			case 'F': n = snprintf(out + len, TIME_REPORTMAX - len, "%ld", ru->ru_majflt); break;
+			case 'f': n = snprintf(out + len, TIME_REPORTMAX - len, "%ld", ru->ru_minflt); break;
+			case 'w': n = snprintf(out + len, TIME_REPORTMAX - len, "%ld", ru->ru_nvcsw); break;
+			case 'c': n = snprintf(out + len, TIME_REPORTMAX - len, "%ld", ru->ru_nivcsw); break;
+			case '%': out[len] = '%'; n = 1; break;
+			default:
+				// Anything else is printed as it is, like in bash: the "%", then whatever followed it ("%3X" stays "%3X")
+				out[len] = '%';
+				n = 1;
+				f = directive - 1;
+				break;
+		}
+		len += n;
+		if(len > TIME_REPORTMAX - 1)
+			len = TIME_REPORTMAX - 1;
+	}
+	out[len++] = '\n';
+
+	// Whatever was printed before the job finished comes first
+	out_sync();
+	fwrite(out, 1, len, stderr);
+}
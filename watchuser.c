@@ -0,0 +1,586 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that implements the "watchuser" command functionality of our Shell
+ *   - "watchuser_set" is the hash set of users that are watched on
+ *     The watchuser thread looks users up without any lock, ONLY the "watchuser" command takes the mutex to change the set
+ *   - The watchuser thread sleeps until utmp changes (inotify), compares the sessions in utmp with the ones it saw before,
+ *     and reports ONLY the logins and logouts of the watched users, with their time
+ *   - Users that are already logged on are reported too: the first look at utmp is compared with NO sessions at all,
+ *     and a user added with "watchuser" wakes the thread up, so the sessions the user already has are reported right away
+ *   - A burst of changes within the coalescing window ("watchuser -w ms") is looked at once
+ */
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <utmpx.h>
+#include <paths.h>
+#include "sh.h"
+
+#define COALESCE_MS 100   // default coalescing window of utmp changes
+
+// Definition for an entry of the hash set "watchuser_set"
+struct user_entry {
+	unsigned int hash;
+	struct user_entry *_Atomic next;   // next entry in the same bucket
+	char user[];                       // name of the user, of ANY length
+};
+
+// The hash set itself: readers find it through ONE atomic pointer, so a writer can replace it as a whole when it grows
+struct user_table {
+	unsigned int nbuckets;              // always a power of 2
+	unsigned int count;
+	struct user_entry *_Atomic buckets[];
+};
+
+/* MUTEX object, ONLY the writers ("watchuser" command) take it */
+pthread_mutex_t m = PTHREAD_MUTEX_INITIALIZER;
+
+// "watchuser_set" is the concurrent hash set that stores the users that needs to be watched on
+static struct user_table *_Atomic watchuser_set = NULL;
+
+// Wakes the watchuser thread up to look at utmp again, written by addUser(...) (-1 until the thread is started)
+static int wake_fd = -1;
+
+/*
+ * Epoch based reclamation of removed entries
+ *   - A reader announces the epoch it started in, in its own slot, and clears the slot when it is done
+ *   - A writer that took entries out of the hash set moves to a new epoch and waits until no reader is still in an older one,
+ *     after which nobody can be looking at those entries anymore and they are freed
+ * Readers never wait and never take a lock, as long as they have a slot
+ *   - A reader thread claims a free slot the first time it reads and gives it back when it exits
+ *   - A reader that finds every slot taken reads with "m" held instead, like a writer, until a slot is free again
+ */
+#define MAX_READERS 8
+
+static _Atomic unsigned long global_epoch = 1;
+static _Atomic unsigned long reader_epoch[MAX_READERS];   // 0 = not reading
+static _Atomic int slot_taken[MAX_READERS];                // 1 = owned by a reader thread
+static pthread_key_t slot_key;
+static pthread_once_t slot_once = PTHREAD_ONCE_INIT;
+static __thread int reader_slot = -1;                      // -1 = no slot (yet)
+static __thread int reader_locked = 0;                     // set while reading with "m" held
+
+// Gives the slot of a reader thread back when the thread exits
+static void release_slot(void *slot){
+	int i = (int) (intptr_t) slot - 1;
+
+	atomic_store(&reader_epoch[i], 0);
+	atomic_store(&slot_taken[i], 0);
+}
+
+static void make_slot_key(){
+	pthread_key_create(&slot_key, release_slot);
+}
+
+// Claims a free slot for the calling thread, returns -1 if every slot is taken
+static int claim_slot(){
+	int i, expected;
+
+	for(i = 0; i < MAX_READERS; i++){
+		expected = 0;
+		if(atomic_compare_exchange_strong(&slot_taken[i], &expected, 1)){
+			pthread_once(&slot_once, make_slot_key);
+			pthread_setspecific(slot_key, (void *) (intptr_t) (i + 1));
+			return i;
+		}
+	}
+	return -1;
+}
+
+// Starts a read-side critical section
+static void read_lock(){
+	unsigned long e;
+
+	if(reader_slot == -1 && (reader_slot = claim_slot()) == -1){
+		// No slot is free: a writer can't see this reader, so the writers are kept out with the lock instead
+		pthread_mutex_lock(&m);
+		reader_locked = 1;
+		return;
+	}
+
+	// Announce the current epoch, again if a writer moved to a new epoch in the meantime
+	do{
+		e = atomic_load(&global_epoch);
+		atomic_store(&reader_epoch[reader_slot], e);
+	}while(atomic_load(&global_epoch) != e);
+}
+
+// Ends a read-side critical section
+static void read_unlock(){
+	if(reader_locked){
+		reader_locked = 0;
+		pthread_mutex_unlock(&m);
+		return;
+	}
+	atomic_store(&reader_epoch[reader_slot], 0);
+}
+
+// In a forked child ONLY the forking thread is left: the slots and the lock of the other threads are freed,
+// otherwise a writer in the child (e.g. "watchuser" in a pipeline) would wait for a reader that doesn't exist there
+static void readers_atfork_child(){
+	int i;
+
+	for(i = 0; i < MAX_READERS; i++){
+		if(i == reader_slot)
+			continue;
+		atomic_store(&reader_epoch[i], 0);
+		atomic_store(&slot_taken[i], 0);
+	}
+	pthread_mutex_init(&m, NULL);
+}
+
+// Waits until every reader that could still see removed entries is done (called by a writer, with "m" held)
+static void synchronize_readers(){
+	unsigned long e = atomic_fetch_add(&global_epoch, 1) + 1;
+	unsigned long r;
+	int i;
+
+	for(i = 0; i < MAX_READERS; i++){
+		while((r = atomic_load(&reader_epoch[i])) != 0 && r < e)
+			sched_yield();
+	}
+}
+
+// FNV-1a hash of a user name
+static unsigned int hash_user(const char *user){
+	unsigned int h = 2166136261u;
+	while(*user){
+		h ^= (unsigned char) *user++;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+static struct user_table *table_new(unsigned int nbuckets){
+	struct user_table *t = (struct user_table *) calloc(1, sizeof(struct user_table) + sizeof(struct user_entry *) * nbuckets);
+	t->nbuckets = nbuckets;
+	return t;
+}
+
+static struct user_entry *entry_new(const char *user, unsigned int h){
+	struct user_entry *e = (struct user_entry *) malloc(sizeof(struct user_entry) + strlen(user) + 1);
+	e->hash = h;
+	atomic_init(&e->next, NULL);
+	strcpy(e->user, user);
+	return e;
+}
+
+// Frees every entry of the table and the table itself, ONLY after synchronize_readers(...)
+static void table_free(struct user_table *t){
+	struct user_entry *e, *next;
+	unsigned int i;
+
+	if(t == NULL)
+		return;
+	for(i = 0; i < t->nbuckets; i++){
+		for(e = atomic_load_explicit(&t->buckets[i], memory_order_relaxed); e != NULL; e = next){
+			next = atomic_load_explicit(&e->next, memory_order_relaxed);
+			free(e);
+		}
+	}
+	free(t);
+}
+
+// Finds the user in the table, the caller is either a reader inside read_lock(...) or a writer holding "m"
+static struct user_entry *table_find(struct user_table *t, const char *user, unsigned int h){
+	struct user_entry *e;
+
+	if(t == NULL)
+		return NULL;
+	for(e = atomic_load_explicit(&t->buckets[h & (t->nbuckets - 1)], memory_order_acquire); e != NULL;
+	    e = atomic_load_explicit(&e->next, memory_order_acquire))
+		if(e->hash == h && strcmp(e->user, user) == 0)
+			return e;
+	return NULL;
+}
+
+// Publishes a new entry at the head of its bucket, the entry is complete before readers can see it
+static void table_insert(struct user_table *t, struct user_entry *e){
+	struct user_entry *_Atomic *bucket = &t->buckets[e->hash & (t->nbuckets - 1)];
+
+	atomic_store_explicit(&e->next, atomic_load_explicit(bucket, memory_order_relaxed), memory_order_relaxed);
+	atomic_store_explicit(bucket, e, memory_order_release);
+	t->count++;
+}
+
+/*
+ * Builds a table twice as big with copies of every entry and swaps it in
+ * Readers keep using the old table until they see the new one, it is freed once they are all done with it
+ */
+static void table_grow(struct user_table *old){
+	struct user_table *t = table_new(old->nbuckets * 2);
+	struct user_entry *e;
+	unsigned int i;
+
+	for(i = 0; i < old->nbuckets; i++)
+		for(e = atomic_load_explicit(&old->buckets[i], memory_order_relaxed); e != NULL; e = atomic_load_explicit(&e->next, memory_order_relaxed))
+			table_insert(t, entry_new(e->user, e->hash));
+
+	atomic_store_explicit(&watchuser_set, t, memory_order_release);
+	synchronize_readers();
+	table_free(old);
+}
+
+/* Helper function for watchuser command
+ * This function adds the given username to the global hash set
+ */
+void addUser(char *username){
+	struct user_table *t;
+	unsigned int h = hash_user(username);
+
+	// ONLY ONE writer at a time
+	pthread_mutex_lock(&m);
+
+	t = atomic_load_explicit(&watchuser_set, memory_order_relaxed);
+	if(t == NULL){
+		t = table_new(16);
+		atomic_store_explicit(&watchuser_set, t, memory_order_release);
+	}
+
+	if(table_find(t, username, h) == NULL){
+		table_insert(t, entry_new(username, h));
+
+		// Keep the chains short: the table grows once it has as many users as buckets
+		if(t->count > t->nbuckets)
+			table_grow(t);
+	}
+	pthread_mutex_unlock(&m);
+
+	// The user may be logged on already
+	if(wake_fd >= 0)
+		eventfd_write(wake_fd, 1);
+}
+
+/* Helper function for watchuser command
+ * This function removes the given username from the global hash set given that the set is not empty
+ */
+void removeUser(char *username){
+	struct user_table *t;
+	struct user_entry *_Atomic *indirect;
+	struct user_entry *e;
+	unsigned int h = hash_user(username);
+
+	// ONLY ONE writer at a time
+	pthread_mutex_lock(&m);
+
+	t = atomic_load_explicit(&watchuser_set, memory_order_relaxed);
+	if(t == NULL || t->count == 0){
+		printf("Watchuser List is empty...\n");
+		pthread_mutex_unlock(&m);
+		return;
+	}
+
+	// "indirect" stores the address of each entry pointer of the bucket, so the entry can be unlinked wherever it is
+	for(indirect = &t->buckets[h & (t->nbuckets - 1)]; (e = atomic_load_explicit(indirect, memory_order_relaxed)) != NULL; indirect = &e->next){
+		if(e->hash == h && strcmp(e->user, username) == 0){
+			// Readers already past this point still see the entry and its "next", so it is freed ONLY after they are done
+			atomic_store_explicit(indirect, atomic_load_explicit(&e->next, memory_order_relaxed), memory_order_release);
+			t->count--;
+			synchronize_readers();
+			free(e);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&m);
+}
+
+/* Helper function for watchuser command
+ * This function checks if a given user is present in the global hash set, without taking any lock
+ * Returns 1 on success and 0 if not present
+ */
+int searchUser(char *username){
+	struct user_entry *e;
+
+	read_lock();
+	e = table_find(atomic_load_explicit(&watchuser_set, memory_order_acquire), username, hash_user(username));
+	read_unlock();
+	return e != NULL;
+}
+
+// Copy of the sessions of utmp at one point of time
+struct utmp_snapshot {
+	struct utmpx *sessions;   // ONLY the USER_PROCESS entries
+	char         *reported;   // set for the sessions whose login was reported
+	int          count;
+};
+
+// Coalescing window in milliseconds, set with "watchuser -w ms"
+static volatile int coalesce_ms = COALESCE_MS;
+
+/*
+ * This function sets the coalescing window of the watchuser thread
+ * After utmp changed, the thread waits until it didn't change for "ms" milliseconds before it looks at it,
+ * so a burst of writes (e.g. login(1) updating utmp several times) is reported only once
+ */
+void watchuser_set_window(int ms){
+	coalesce_ms = ms;
+}
+
+int watchuser_get_window(){
+	return coalesce_ms;
+}
+
+/*
+ * Reads the current sessions from utmp in ONE pass over the file
+ * The file is read directly instead of with getutxent(...), which keeps its state in static variables of the C library
+ */
+static void read_snapshot(struct utmp_snapshot *snap){
+	struct utmpx entries[64];
+	ssize_t got;
+	int fd, i, cap = 0;
+
+	snap->sessions = NULL;
+	snap->reported = NULL;
+	snap->count = 0;
+
+	if((fd = open(_PATH_UTMP, O_RDONLY | O_CLOEXEC)) < 0)
+		return;
+
+	while((got = read(fd, entries, sizeof(entries))) >= (ssize_t) sizeof(struct utmpx)){
+		for(i = 0; i < got / (ssize_t) sizeof(struct utmpx); i++){
+			if(entries[i].ut_type != USER_PROCESS)   /* only care about users */
+				continue;
+			if(snap->count == cap){
+				cap = cap ? 2 * cap : 16;
+				snap->sessions = (struct utmpx *) realloc(snap->sessions, sizeof(struct utmpx) * cap);
+				snap->reported = (char *) realloc(snap->reported, cap);
+			}
+			snap->reported[snap->count] = 0;
+			snap->sessions[snap->count++] = entries[i];
+		}
+	}
+	close(fd);
+}
+
+// Finds the session in the snapshot (same terminal line, same process and same user)
+// Returns its index, or -1 if it is not there
+static int in_snapshot(struct utmp_snapshot *snap, struct utmpx *session){
+	int i;
+
+	for(i = 0; i < snap->count; i++){
+		if(snap->sessions[i].ut_pid == session->ut_pid &&
+		   strncmp(snap->sessions[i].ut_line, session->ut_line, sizeof(session->ut_line)) == 0 &&
+		   strncmp(snap->sessions[i].ut_user, session->ut_user, sizeof(session->ut_user)) == 0)
+			return i;
+	}
+	return -1;
+}
+
+// Checks if the user of the session is watched on
+static int is_watched(struct utmpx *session){
+	char user[sizeof(session->ut_user) + 1];
+
+	// "ut_user" is not NUL terminated if it fills up the whole field
+	memcpy(user, session->ut_user, sizeof(session->ut_user));
+	user[sizeof(session->ut_user)] = '\0';
+
+	// The watchuser thread is a reader of the hash set, it never waits for the "watchuser" command
+	return searchUser(user);
+}
+
+// Queues the notification of a login or logout of a session for the main thread, see "event.c"
+static void report(struct utmpx *session, int logged_on){
+	char message[sizeof(session->ut_user) + sizeof(session->ut_line) + sizeof(session->ut_host) + 64];
+	char stamp[16];
+	time_t when;
+	struct tm tm;
+
+	// A login is stamped with the time utmp has for it, a logout with the time it was seen
+	when = logged_on ? (time_t) session->ut_tv.tv_sec : time(NULL);
+	localtime_r(&when, &tm);
+	strftime(stamp, sizeof(stamp), "%H:%M:%S", &tm);
+
+	if(logged_on)
+		snprintf(message, sizeof(message), "[%s] %.*s has logged on %.*s from %.*s\n", stamp,
+			(int) sizeof(session->ut_user), session->ut_user, (int) sizeof(session->ut_line), session->ut_line,
+			(int) sizeof(session->ut_host), session->ut_host);
+	else
+		snprintf(message, sizeof(message), "[%s] %.*s has logged off %.*s\n", stamp,
+			(int) sizeof(session->ut_user), session->ut_user, (int) sizeof(session->ut_line), session->ut_line);
+	event_notify(message);
+}
+
+// Frees the snapshot when the watchuser thread is cancelled
+static void free_snapshot(void *arg){
+	struct utmp_snapshot *snap = (struct utmp_snapshot *) arg;
+	free(snap->sessions);
+	free(snap->reported);
+	snap->sessions = NULL;
+	snap->reported = NULL;
+	snap->count = 0;
+}
+
+// Closes the inotify instance when the watchuser thread is cancelled
+static void close_fd(void *arg){
+	close(*(int *) arg);
+}
+
+/*
+ * Waits until utmp changes (or a user is added) and then until it stays unchanged for the coalescing window
+ * Returns -1 if the inotify instance can't be read anymore
+ */
+static int wait_for_change(int fd, const char *name){
+	char events[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+	struct inotify_event *ev;
+	struct pollfd pfd[2];
+	eventfd_t added;
+	ssize_t got;
+	char *p;
+	int n, changed = 0;
+
+	pfd[0].fd = fd;
+	pfd[0].events = POLLIN;
+	pfd[1].fd = wake_fd;
+	pfd[1].events = POLLIN;
+
+	// Sleeps until something happens in the directory of utmp, then drains events until it is quiet
+	while(1){
+		n = poll(pfd, 2, changed ? coalesce_ms : -1);
+		if(n == 0)
+			return 0;
+		if(n < 0){
+			if(errno == EINTR)
+				continue;
+			return -1;
+		}
+
+		if(pfd[1].revents & POLLIN){
+			eventfd_read(wake_fd, &added);
+			changed = 1;
+		}
+		if(!(pfd[0].revents & (POLLIN | POLLERR | POLLHUP)))
+			continue;
+
+		got = read(fd, events, sizeof(events));
+		if(got <= 0){
+			if(got < 0 && errno == EINTR)
+				continue;
+			return -1;
+		}
+
+		// ONLY the events of the utmp file matter, not of the other files of the directory
+		for(p = events; p < events + got; p += sizeof(struct inotify_event) + ev->len){
+			ev = (struct inotify_event *) p;
+			if(ev->len > 0 && strcmp(ev->name, name) == 0)
+				changed = 1;
+		}
+	}
+}
+
+/* This is the thread function that watchuser thread executes upon calling "watchuser" command
+ * The thread sleeps until utmp changes (inotify on the directory of utmp, so a new or replaced utmp is seen too),
+ * reads the new sessions and compares them with the previous ones
+ * ONLY new logins and logouts of the users in "watchuser_set" are reported
+ */
+void *thread_function(){
+	struct utmp_snapshot prev, cur;
+	char dir[sizeof(_PATH_UTMP)], *name;
+	int fd, i, j, oldstate;
+
+	// The directory and the name of the utmp file
+	strcpy(dir, _PATH_UTMP);
+	name = strrchr(dir, '/');
+	*name++ = '\0';
+
+	fd = inotify_init1(IN_CLOEXEC);
+	if(fd < 0 || inotify_add_watch(fd, dir, IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO | IN_DELETE) < 0){
+		if(fd >= 0)
+			close(fd);
+		event_notify("watchuser: Can't watch " _PATH_UTMP ".\n");
+		return NULL;
+	}
+
+	// Nothing was seen yet, so the first look at utmp reports everyone watched that is already logged on
+	prev.sessions = NULL;
+	prev.reported = NULL;
+	prev.count = 0;
+	pthread_cleanup_push(close_fd, &fd);
+	pthread_cleanup_push(free_snapshot, &prev);
+
+	do{
+		// "cur" is not known to the cleanup handlers, so the thread can't be cancelled until it became "prev"
+		// (read(...) in read_snapshot(...) and write(...) in report(...) are cancellation points)
+		pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldstate);
+		read_snapshot(&cur);
+
+		// Logins: sessions that were not reported yet, either new ones or ones of a user watched since the last look
+		for(i = 0; i < cur.count; i++){
+			j = in_snapshot(&prev, &cur.sessions[i]);
+			cur.reported[i] = j >= 0 && prev.reported[j];
+			if(!cur.reported[i] && is_watched(&cur.sessions[i])){
+				report(&cur.sessions[i], 1);
+				cur.reported[i] = 1;
+			}
+		}
+		for(i = 0; i < prev.count; i++)      // logouts: in the old snapshot ONLY
+			if(prev.reported[i] && in_snapshot(&cur, &prev.sessions[i]) < 0 && is_watched(&prev.sessions[i]))
+				report(&prev.sessions[i], 0);
+
+		free(prev.sessions);
+		free(prev.reported);
+		prev = cur;
+		pthread_setcancelstate(oldstate, NULL);
+	}while(wait_for_change(fd, name) == 0);
+
+	pthread_cleanup_pop(1);
+	pthread_cleanup_pop(1);
+	return NULL;
+}
+
+pthread_t *thread_handles = NULL; /* Buffer for watchuser thread */
+
+/*
+ * This function creates the watchuser thread the first time it is called
+ * This makes sure that ONLY ONE watchuser thread should ever be running
+ */
+void watchuser_start(){
+	if(thread_handles != NULL)
+		return;
+
+	thread_handles = (pthread_t *) malloc(sizeof(pthread_t));
+	wake_fd = eventfd(0, EFD_CLOEXEC);
+	pthread_atfork(NULL, NULL, readers_atfork_child);
+
+	/* Creates a watchuser thread executing thread_function() */
+	pthread_create(thread_handles, NULL, &thread_function, NULL);
+}
+
+/*
+ * This function stops the watchuser thread (if it was ever started) before the shell exits
+ */
+void watchuser_stop(){
+	/* Check and make sure that watchuser command has been runned ATLEAST once to call pthread_cancel(...) and pthread_join(...) */
+	/* Prevents Segmentation Fault error */
+	if(thread_handles != NULL) {
+
+		/* Prevents memory leak from watchuser thread */
+		pthread_cancel(*thread_handles);     /* Sends a cancellation request to the watchuser thread "thread_handles" */
+		pthread_join(*thread_handles, NULL); /* Joining with a thread is the only way to know that cancellation has completed and thus avoiding memory leak */
+		free(thread_handles);
+		thread_handles = NULL;
+		close(wake_fd);
+		wake_fd = -1;
+
+		/* The watchuser thread was the ONLY reader, so the hash set can be freed right away */
+		table_free(atomic_exchange(&watchuser_set, NULL));
+
+		/* Destroys MUTEX object */
+		pthread_mutex_destroy(&m);
+	}
+}
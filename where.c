@@ -4,39 +4,78 @@
  * Date: March 13th, 2021
  *
  * This is the simple program that implements "where" command functionality of our Shell
+ *   - resolve_commands() looks up ALL the names of one "where" or "which" command in ONE pass over PATH:
+ *     each dir is visited once for every name, asking the PATH index (see pathindex.c), and a dir the index
+ *     doesn't know is opened once and checked with faccessat() relative to it
+ *   - the paths are allocated to their exact size, there is no fixed-size buffer anywhere
  */
 
+#define _GNU_SOURCE
+#include <fcntl.h>
 #include "get_path.h"
-#define BUFFERSIZE 128
 
-// This is the helper function for implementing "where" command
-char **where(char *command, struct pathelement *p)
+/* adds a match to the matches of one name */
+static void add_match(struct resolved *r, const char *dir, const char *name)
 {
-  char cmd[64], **ch = (char **) malloc(sizeof(char *) * BUFFERSIZE);
-  int index;
-  int  found;
-
-  index = 0;
-  found = 0;
-  while (p) {
-    sprintf(cmd, "%s/%s", p->element, command);
-    if (access(cmd, X_OK) == 0) {
-      found = 1;
-      ch[index] = (char *) malloc(sizeof(char) * (strlen(cmd) + 1));
-      strcpy(ch[index],cmd);
-      index++;
-    }
-    p = p->next;
+  char *path = malloc(strlen(dir) + strlen(name) + 2);
+
+  sprintf(path, "%s/%s", dir, name);
+  if (r->count + 1 >= r->cap) {
+    r->cap = r->cap ? 2 * r->cap : 4;
+    r->paths = realloc(r->paths, sizeof(char *) * r->cap);
   }
-  if(index){
-	  ch[index] = NULL;
+  r->paths[r->count++] = path;
+  r->paths[r->count] = NULL;
+}
+
+/* This function finds every name in the PATH "p" at once, into res[i] for names[i],
+   with the matches of each name in PATH order.
+   With "first_only" (which), a name is no longer looked for once found.
+   The matches are released with free_resolved(). */
+void resolve_commands(struct pathlist *p, char **names, int count, int first_only, struct resolved *res)
+{
+  int i, j, known, dirfd, left = count;
+
+  /* a PATH dir that changed since the index was read is read again (at most once a second) */
+  pathindex_revalidate();
+
+  for (j = 0; j < count; j++) {
+    res[j].paths = NULL;
+    res[j].count = res[j].cap = 0;
   }
 
-  if(!found){
-	  free(ch);
-	  return (char **) NULL;
+  for (i = 0; i < p->count && left > 0; i++) {
+    dirfd = -1;
+    for (j = 0; j < count; j++) {
+      if (first_only && res[j].count > 0)
+        continue;
+
+      known = pathindex_contains(i, names[j]);
+      if (known == -1) {
+        /* a dir the index doesn't know is opened ONCE for all the names */
+        if (dirfd == -1)
+          dirfd = open(p->dirs[i], O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        known = dirfd >= 0 && faccessat(dirfd, names[j], X_OK, 0) == 0;
+      }
+      if (known) {
+        add_match(&res[j], p->dirs[i], names[j]);
+        if (first_only)
+          left--;
+      }
+    }
+    if (dirfd >= 0)
+      close(dirfd);
   }
-  else
-	  return ch;
 }
 
+/* frees the matches of resolve_commands() */
+void free_resolved(struct resolved *res, int count)
+{
+  int i, j;
+
+  for (j = 0; j < count; j++) {
+    for (i = 0; i < res[j].count; i++)
+      free(res[j].paths[i]);
+    free(res[j].paths);
+  }
+}
@@ -9,25 +9,17 @@
 #include "get_path.h"
 
 // This is the helper function for implementing "which" command
-char *which(char *command, struct pathelement *p)
+// Returns the first match of the command in PATH (allocated), or NULL if there is none
+char *which(char *command, struct pathlist *p)
 {
-  char cmd[64], *ch;
-  int  found;
+  struct resolved r;
+  char *ch;
 
-  found = 0;
-  while (p) {       
-    sprintf(cmd, "%s/%s", p->element, command);
-    if (access(cmd, X_OK) == 0) {
-      found = 1;
-      break;
-    }
-    p = p->next;
-  }
-  if (found) {
-    ch = malloc(strlen(cmd)+1);
-    strcpy(ch, cmd);
-    return ch;
-  }
-  else
+  resolve_commands(p, &command, 1, 1, &r);
+  if (r.count == 0)
     return (char *) NULL;
+
+  ch = r.paths[0];
+  free(r.paths);
+  return ch;
 }
@@ -0,0 +1,478 @@
+/*
+ * Author: Raj Trivedi
+ * Partner Name: James Cooper
+ * Date: October 17th, 2026
+ *
+ * This is the program that expands the wildcards ("*", "?", "[...]" and "**") in the arguments of our Shell
+ *   - The shell matches the patterns itself instead of calling glob(...) once per argument
+ *   - Each directory is read ONCE per pipeline into a cache, and EVERY pattern of every command of the pipeline is matched
+ *     against the cached names, so "ls *.c *.h | grep *.h" reads the current directory one time only
+ *     The cache is NOT kept for the next pipeline of the line, which may have changed the directory ("touch x; echo *")
+ *   - A path component "**" matches zero or more directories, recursively (hidden directories and symbolic links are skipped)
+ *   - The matches of each pattern are sorted, and a pattern that matches nothing is kept as it is
+ *   - The pattern comes from the lexer, with the wildcards that were quoted escaped with "\", so ONLY the unquoted ones match
+ *   - The expanded arguments go into a growable list, so a command can have ANY number of arguments
+ */
+
+#define _GNU_SOURCE
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <fnmatch.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sh.h"
+
+// One name of a cached directory
+struct dir_entry {
+	size_t        name;   // offset of the name in the "pool" of its directory
+	unsigned char type;   // "d_type" from readdir(...), DT_UNKNOWN if the file system doesn't tell
+};
+
+// One directory read into the cache
+struct dir_listing {
+	char   *path;                // directory as written in the pattern ("src/"), "" for the current directory
+	char   *pool;                // ALL the names of the directory, one after another, each NUL terminated
+	size_t  poolsize;
+	struct dir_entry *entries;   // sorted by name
+	int     nentries;
+	struct dir_listing *next;    // next listing in the same bucket of the cache
+};
+
+// The directories read so far for ONE pipeline
+struct dir_cache {
+	struct dir_listing **buckets;
+	unsigned int nbuckets;       // always a power of 2
+	unsigned int count;
+};
+
+// Path being built while a pattern is matched, component after component
+struct pathbuf {
+	char  *s;
+	size_t len;
+	size_t cap;
+};
+
+// One path component of a pattern
+struct component {
+	char *pattern;   // as written, with escaped wildcards, for fnmatch(...)
+	char *name;      // without the escapes, NULL if the component has unescaped wildcards
+};
+
+// Matches of ONE pattern
+struct matches {
+	char **v;
+	int    n;
+	int    cap;
+};
+
+static unsigned int hash_path(const char *s){
+	unsigned int h = 2166136261u;
+	while(*s){
+		h ^= (unsigned char) *s++;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+// Compares two names of the same directory, "pool" is the pool of that directory
+static int entry_cmp(const void *a, const void *b, void *pool){
+	return strcmp((char *) pool + ((const struct dir_entry *) a)->name, (char *) pool + ((const struct dir_entry *) b)->name);
+}
+
+// Reads EVERY name of the directory into the listing, except "." and ".."
+// A directory that can't be read (it doesn't exist, or it is not a directory) is an empty listing
+static void read_listing(struct dir_listing *d){
+	struct dirent *de;
+	size_t poolcap = 0, len;
+	int cap = 0;
+	DIR *dir;
+
+	d->pool = NULL;
+	d->poolsize = 0;
+	d->entries = NULL;
+	d->nentries = 0;
+
+	if((dir = opendir(d->path[0] ? d->path : ".")) == NULL)
+		return;
+
+	while((de = readdir(dir)) != NULL){
+		if(de->d_name[0] == '.' && (de->d_name[1] == '\0' || (de->d_name[1] == '.' && de->d_name[2] == '\0')))
+			continue;
+
+		len = strlen(de->d_name) + 1;
+		if(d->poolsize + len > poolcap){
+			poolcap = poolcap ? 2 * poolcap : 4096;
+			while(d->poolsize + len > poolcap)
+				poolcap *= 2;
+			d->pool = (char *) realloc(d->pool, poolcap);
+		}
+		if(d->nentries == cap){
+			cap = cap ? 2 * cap : 64;
+			d->entries = (struct dir_entry *) realloc(d->entries, sizeof(struct dir_entry) * cap);
+		}
+		memcpy(d->pool + d->poolsize, de->d_name, len);
+		d->entries[d->nentries].name = d->poolsize;
+		d->entries[d->nentries].type = de->d_type;
+		d->nentries++;
+		d->poolsize += len;
+	}
+	closedir(dir);
+
+	// Sorted, so that a plain name after a wildcard ("*/Makefile") is found with a binary search
+	qsort_r(d->entries, d->nentries, sizeof(struct dir_entry), entry_cmp, d->pool);
+}
+
+// Doubles the number of buckets of the cache once it has twice as many directories as buckets
+static void cache_grow(struct dir_cache *c){
+	unsigned int nbuckets = c->nbuckets ? 2 * c->nbuckets : 64;
+	struct dir_listing **buckets = (struct dir_listing **) calloc(nbuckets, sizeof(struct dir_listing *));
+	struct dir_listing *d, *next;
+	unsigned int i, b;
+
+	for(i = 0; i < c->nbuckets; i++){
+		for(d = c->buckets[i]; d != NULL; d = next){
+			next = d->next;
+			b = hash_path(d->path) & (nbuckets - 1);
+			d->next = buckets[b];
+			buckets[b] = d;
+		}
+	}
+	free(c->buckets);
+	c->buckets = buckets;
+	c->nbuckets = nbuckets;
+}
+
+// Returns the listing of the directory, reading it ONLY the first time it is asked for
+static struct dir_listing *cache_get(struct dir_cache *c, const char *path){
+	struct dir_listing *d;
+	unsigned int b;
+
+	if(c->nbuckets == 0 || c->count > 2 * c->nbuckets)
+		cache_grow(c);
+
+	b = hash_path(path) & (c->nbuckets - 1);
+	for(d = c->buckets[b]; d != NULL; d = d->next)
+		if(strcmp(d->path, path) == 0)
+			return d;
+
+	d = (struct dir_listing *) malloc(sizeof(struct dir_listing));
+	d->path = strdup(path);
+	read_listing(d);
+	d->next = c->buckets[b];
+	c->buckets[b] = d;
+	c->count++;
+	return d;
+}
+
+/*
+ * This function creates an empty directory cache for the commands of ONE pipeline
+ */
+struct dir_cache *dir_cache_new(){
+	return (struct dir_cache *) calloc(1, sizeof(struct dir_cache));
+}
+
+/*
+ * This function frees the cache and every directory listing in it
+ */
+void dir_cache_free(struct dir_cache *c){
+	struct dir_listing *d, *next;
+	unsigned int i;
+
+	for(i = 0; i < c->nbuckets; i++){
+		for(d = c->buckets[i]; d != NULL; d = next){
+			next = d->next;
+			free(d->path);
+			free(d->pool);
+			free(d->entries);
+			free(d);
+		}
+	}
+	free(c->buckets);
+	free(c);
+}
+
+// Checks if the entry is a directory, with lstat(...) ONLY if readdir(...) didn't tell
+// "follow" also takes a symbolic link to a directory as a directory
+static int is_dir(struct dir_listing *d, struct dir_entry *e, int follow){
+	struct stat st;
+	char *full;
+	int r;
+
+	if(e->type == DT_DIR)
+		return 1;
+	if(e->type != DT_UNKNOWN && !(e->type == DT_LNK && follow))
+		return 0;
+
+	// The name is relative to the directory of the listing
+	full = (char *) malloc(strlen(d->path) + strlen(d->pool + e->name) + 1);
+	strcpy(full, d->path);
+	strcat(full, d->pool + e->name);
+	r = fstatat(AT_FDCWD, full, &st, follow ? 0 : AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(st.st_mode);
+	free(full);
+	return r;
+}
+
+// Finds the name in the sorted listing with a binary search, NULL if it is not there
+static struct dir_entry *find_entry(struct dir_listing *d, const char *name){
+	int lo = 0, hi = d->nentries - 1, mid, r;
+
+	while(lo <= hi){
+		mid = (lo + hi) / 2;
+		r = strcmp(name, d->pool + d->entries[mid].name);
+		if(r == 0)
+			return &d->entries[mid];
+		if(r < 0)
+			hi = mid - 1;
+		else
+			lo = mid + 1;
+	}
+	return NULL;
+}
+
+static void pathbuf_add(struct pathbuf *p, const char *s){
+	size_t len = strlen(s);
+
+	if(p->len + len + 1 > p->cap){
+		p->cap = p->cap ? p->cap : 256;
+		while(p->len + len + 1 > p->cap)
+			p->cap *= 2;
+		p->s = (char *) realloc(p->s, p->cap);
+	}
+	memcpy(p->s + p->len, s, len + 1);
+	p->len += len;
+}
+
+// Goes back to the given length of the path
+static void pathbuf_cut(struct pathbuf *p, size_t len){
+	p->len = len;
+	p->s[len] = '\0';
+}
+
+static void matches_add(struct matches *m, const char *path){
+	if(m->n == m->cap){
+		m->cap = m->cap ? 2 * m->cap : 16;
+		m->v = (char **) realloc(m->v, sizeof(char *) * m->cap);
+	}
+	m->v[m->n++] = strdup(path);
+}
+
+static int match_cmp(const void *a, const void *b){
+	return strcmp(*(char * const *) a, *(char * const *) b);
+}
+
+// Checks for a wildcard that is not escaped with "\"
+static int has_wildcard(const char *s){
+	for(; *s; s++){
+		if(*s == '\\' && s[1])
+			s++;
+		else if(*s == '*' || *s == '?' || *s == '[')
+			return 1;
+	}
+	return 0;
+}
+
+// Removes the escapes of a pattern without wildcards, in place ("a\*b" is the name "a*b")
+static void unescape(char *s){
+	char *to = s;
+
+	for(; *s; s++){
+		if(*s == '\\' && s[1])
+			s++;
+		*to++ = *s;
+	}
+	*to = '\0';
+}
+
+/*
+ * This function matches the components "comps[i...n-1]" of a pattern below the directory in "path", adding every match to "m"
+ * "dir_only" is set if the pattern ends with "/", so ONLY directories match it
+ */
+static void match_from(struct dir_cache *c, struct pathbuf *path, struct component *comps, int n, int i, int dir_only, struct matches *m){
+	struct dir_listing *d;
+	struct dir_entry *e;
+	size_t len = path->len;
+	int k, last = (i == n - 1);
+
+	if(i == n){
+		matches_add(m, path->s);
+		return;
+	}
+
+	// A plain name before any wildcard ("src" in "src/*.c") is just added to the path,
+	// reading its parent directory is not needed
+	if(comps[i].name != NULL && !last){
+		pathbuf_add(path, comps[i].name);
+		pathbuf_add(path, "/");
+		match_from(c, path, comps, n, i + 1, dir_only, m);
+		pathbuf_cut(path, len);
+		return;
+	}
+
+	d = cache_get(c, path->s);
+
+	// A plain name at the end of the pattern ("*/Makefile") has to be in the directory
+	if(comps[i].name != NULL){
+		e = find_entry(d, comps[i].name);
+		if(e != NULL && (!dir_only || is_dir(d, e, 1))){
+			pathbuf_add(path, comps[i].name);
+			if(dir_only)
+				pathbuf_add(path, "/");
+			matches_add(m, path->s);
+			pathbuf_cut(path, len);
+		}
+		return;
+	}
+
+	// "**" matches zero or more directories: the rest of the pattern is matched here and in EVERY directory below
+	if(strcmp(comps[i].pattern, "**") == 0){
+		if(!last)
+			match_from(c, path, comps, n, i + 1, dir_only, m);
+
+		for(k = 0; k < d->nentries; k++){
+			e = &d->entries[k];
+			if(d->pool[e->name] == '.')
+				continue;
+			pathbuf_add(path, d->pool + e->name);
+
+			// A "**" at the end matches every file at any depth, like "*" does in one directory
+			if(last && (!dir_only || is_dir(d, e, 1))){
+				if(dir_only)
+					pathbuf_add(path, "/");
+				matches_add(m, path->s);
+				pathbuf_cut(path, len + strlen(d->pool + e->name));
+			}
+
+			// Symbolic links are not followed, so a link to a parent directory can't loop forever
+			if(is_dir(d, e, 0)){
+				pathbuf_add(path, "/");
+				match_from(c, path, comps, n, i, dir_only, m);
+			}
+			pathbuf_cut(path, len);
+		}
+		return;
+	}
+
+	for(k = 0; k < d->nentries; k++){
+		e = &d->entries[k];
+
+		// FNM_PERIOD: a leading "." has to be matched by a "." in the pattern, so "*" skips hidden files
+		if(fnmatch(comps[i].pattern, d->pool + e->name, FNM_PERIOD) != 0)
+			continue;
+		if((!last || dir_only) && !is_dir(d, e, 1))
+			continue;
+
+		pathbuf_add(path, d->pool + e->name);
+		if(!last || dir_only)
+			pathbuf_add(path, "/");
+		match_from(c, path, comps, n, last ? n : i + 1, dir_only, m);
+		pathbuf_cut(path, len);
+	}
+}
+
+/*
+ * This function matches ONE pattern against the cache and adds its sorted matches to "m"
+ */
+static void match_pattern(struct dir_cache *c, const char *pattern, struct matches *m){
+	struct pathbuf path = { NULL, 0, 0 };
+	char *copy = strdup(pattern), *comp, *save;
+	struct component *comps = NULL;
+	int n = 0, cap = 0, dir_only, first = m->n;
+
+	dir_only = pattern[0] != '\0' && pattern[strlen(pattern) - 1] == '/';
+
+	pathbuf_add(&path, pattern[0] == '/' ? "/" : "");
+
+	// "a//b" is the same as "a/b", empty components are skipped
+	for(comp = strtok_r(copy, "/", &save); comp != NULL; comp = strtok_r(NULL, "/", &save)){
+		if(n == cap){
+			cap = cap ? 2 * cap : 8;
+			comps = (struct component *) realloc(comps, sizeof(struct component) * cap);
+		}
+		comps[n].pattern = comp;
+		comps[n].name = NULL;
+
+		// A component without wildcards is a plain name, which is used as it is instead of being matched
+		if(!has_wildcard(comp)){
+			comps[n].name = strdup(comp);
+			unescape(comps[n].name);
+		}
+		n++;
+	}
+
+	if(n > 0)
+		match_from(c, &path, comps, n, 0, dir_only, m);
+
+	qsort(m->v + first, m->n - first, sizeof(char *), match_cmp);
+
+	while(n > 0)
+		free(comps[--n].name);
+	free(comps);
+	free(copy);
+	free(path.s);
+}
+
+// Appends one argument to the list, "allocated" tells if free_args(...) has to free it
+static void args_add(struct arglist *args, char *arg, char allocated){
+	if(args->argc + 1 >= args->cap){
+		args->cap = args->cap ? 2 * args->cap : 16;
+		args->argv = (char **) realloc(args->argv, sizeof(char *) * args->cap);
+		args->allocated = (char *) realloc(args->allocated, sizeof(char) * args->cap);
+	}
+	args->allocated[args->argc] = allocated;
+	args->argv[args->argc++] = arg;
+	args->argv[args->argc] = NULL;
+}
+
+/*
+ * This function expands the arguments of a command into "args", matching the arguments with wildcards against the file system
+ * The directories are read through "cache", so EVERY directory is read at most once for all the commands sharing it
+ * Returns the number of arguments, the list is released with free_args(...)
+ */
+int expand_args(struct command *cmd, struct arglist *args, struct dir_cache *cache){
+	struct matches m = { NULL, 0, 0 };
+	int i, j;
+
+	args->argv = NULL;
+	args->allocated = NULL;
+	args->argc = args->cap = 0;
+
+	args_add(args, cmd->argv[0], 0);
+	for(i = 1; i < cmd->argc; i++){
+		if(!cmd->glob[i]){
+			args_add(args, cmd->argv[i], 0);
+			continue;
+		}
+
+		m.n = 0;
+		match_pattern(cache, cmd->glob[i], &m);
+
+		// If nothing matches, the pattern itself is kept as the argument
+		if(m.n == 0)
+			args_add(args, cmd->argv[i], 0);
+		for(j = 0; j < m.n; j++)
+			args_add(args, m.v[j], 1);
+	}
+
+	free(m.v);
+	return args->argc;
+}
+
+/*
+ * This function frees the arguments that expand_args(...) allocated, and the list itself
+ */
+void free_args(struct arglist *args){
+	int i;
+
+	for(i = 0; i < args->argc; i++)
+		if(args->allocated[i])
+			free(args->argv[i]);
+	free(args->argv);
+	free(args->allocated);
+	args->argv = NULL;
+	args->allocated = NULL;
+	args->argc = args->cap = 0;
+}